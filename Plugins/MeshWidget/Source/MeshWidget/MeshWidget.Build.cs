@@ -29,6 +29,9 @@ public class MeshWidget : ModuleRules
 
 		// Uncomment if you are using Slate UI
 		 PrivateDependencyModuleNames.AddRange(new string[] { "CoreUobject","Engine", "Slate", "SlateCore", "SlateRHIRenderer", "UMG" });
+
+		// Finds the plugin's config for the memreport commands
+		PrivateDependencyModuleNames.Add("Projects");
 		
 		// Uncomment if you are using online features
 		// PrivateDependencyModuleNames.Add("OnlineSubsystem");
@@ -0,0 +1,660 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "InstancedMeshWidgetComponent.h"
+#include "IMeshWidget.h"
+#include "MeshWidgetSubsystem.h"
+#include "MeshWidgetRendering.h"
+#include "MeshWidgetScalability.h"
+#include "MeshWidgetStats.h"
+
+#include "SlateCore/Public/Input/HittestGrid.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Slate/WidgetRenderer.h"
+#include "Engine/StaticMesh.h"
+#include "Runtime/Engine/Classes/Materials/MaterialInstanceDynamic.h"
+#include "Runtime/Engine/Classes/Engine/TextureRenderTarget2D.h"
+#include "MeshWidgetRenderTargetPool.h"
+
+
+namespace InstancedMeshWidget
+{
+	static const FName SlateUI(TEXT("SlateUI"));
+	static const FName BackColor(TEXT("BackColor"));
+
+	/** Custom data floats holding the UV scale and offset of an instance's region */
+	const int32 AtlasCustomDataFloats = 4;
+
+	/** Size of the atlas, unless a single widget needs more */
+	const int32 InitialAtlasSize = 1024;
+
+	/** The atlas grows up to this size, instances that don't fit anymore show nothing */
+	const int32 MaxAtlasSize = 8192;
+}
+
+UInstancedMeshWidgetComponent::UInstancedMeshWidgetComponent( const FObjectInitializer& PCIP )
+	: Super( PCIP )
+	, DrawSize( FIntPoint( 256, 256 ) )
+	, RedrawTime( 0 )
+	, MaxRedrawsPerFrame( 8 )
+	, TickWhenOffscreen( false )
+	, bWindowFocusable( true )
+	, BackgroundColor( FLinearColor::Transparent )
+	, AtlasMaterial( nullptr )
+	, RenderTarget( nullptr )
+	, bAtlasLayoutDirty( true )
+	, MaterialInstance( nullptr )
+	, NumRedrawsLastFrame( 0 )
+	, LastHitInstanceIndex( INDEX_NONE )
+	, LastLocalHitLocation( FVector2D::ZeroVector )
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	bTickInEditor = true;
+
+	BodyInstance.SetCollisionProfileName(FName(TEXT("UI")));
+
+	NumCustomDataFloats = InstancedMeshWidget::AtlasCustomDataFloats;
+}
+
+void UInstancedMeshWidgetComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ReleaseResources();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UInstancedMeshWidgetComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if ( !WidgetRenderer.IsValid() && !GUsingNullRHI )
+	{
+		WidgetRenderer = MakeShareable(new FWidgetRenderer());
+
+		// Every instance owns a region of the same render target, so only that region may be cleared
+		WidgetRenderer->SetShouldClearTarget(false);
+	}
+
+	SyncInstances();
+
+	if ( UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() )
+	{
+		Subsystem->RegisterComponent(this);
+	}
+
+	// Instances added before registering couldn't create their widgets yet
+	for ( FMeshWidgetInstance& Instance : Instances )
+	{
+		InitInstance(Instance);
+	}
+}
+
+void UInstancedMeshWidgetComponent::OnUnregister()
+{
+#if WITH_EDITOR
+	if ( !GetWorld()->IsGameWorld() )
+	{
+		ReleaseResources();
+	}
+#endif
+
+	if ( UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() )
+	{
+		Subsystem->UnregisterComponent(this);
+	}
+
+	Super::OnUnregister();
+}
+
+void UInstancedMeshWidgetComponent::DestroyComponent(bool bPromoteChildren/*= false*/)
+{
+	Super::DestroyComponent(bPromoteChildren);
+
+	ReleaseResources();
+}
+
+FPrimitiveSceneProxy* UInstancedMeshWidgetComponent::CreateSceneProxy()
+{
+	if ( WidgetRenderer.IsValid() && AtlasMaterial )
+	{
+		if ( MaterialInstance == nullptr || MaterialInstance->Parent != AtlasMaterial )
+		{
+			MaterialInstance = UMaterialInstanceDynamic::Create(AtlasMaterial, this);
+		}
+
+		MaterialInstance->SetTextureParameterValue(InstancedMeshWidget::SlateUI, RenderTarget);
+		MaterialInstance->SetVectorParameterValue(InstancedMeshWidget::BackColor, BackgroundColor);
+
+		if ( OverrideMaterials.Num() == 0 )
+		{
+			OverrideMaterials.AddZeroed(1);
+		}
+
+		OverrideMaterials[0] = MaterialInstance;
+	}
+
+	return Super::CreateSceneProxy();
+}
+
+int32 UInstancedMeshWidgetComponent::AddInstance(const FTransform& InstanceTransform)
+{
+	const int32 InstanceIndex = Super::AddInstance(InstanceTransform);
+
+	SyncInstances();
+
+	return InstanceIndex;
+}
+
+bool UInstancedMeshWidgetComponent::RemoveInstance(int32 InstanceIndex)
+{
+	if ( !Super::RemoveInstance(InstanceIndex) )
+	{
+		return false;
+	}
+
+	// The instances after the removed one move down, like the instance data does
+	if ( Instances.IsValidIndex(InstanceIndex) )
+	{
+		ReleaseInstance(Instances[InstanceIndex]);
+		Instances.RemoveAt(InstanceIndex);
+	}
+
+	return true;
+}
+
+void UInstancedMeshWidgetComponent::ClearInstances()
+{
+	for ( FMeshWidgetInstance& Instance : Instances )
+	{
+		ReleaseInstance(Instance);
+	}
+	Instances.Reset();
+
+	Super::ClearInstances();
+}
+
+void UInstancedMeshWidgetComponent::ReleaseResources()
+{
+	for ( FMeshWidgetInstance& Instance : Instances )
+	{
+		ReleaseInstance(Instance);
+	}
+
+	WidgetRenderer.Reset();
+
+	ReleaseAtlasRenderTarget();
+	AtlasAllocator = FMeshWidgetAtlasAllocator();
+	bAtlasLayoutDirty = true;
+}
+
+void UInstancedMeshWidgetComponent::InitInstance(FMeshWidgetInstance& Instance)
+{
+	// Don't do any work if Slate is not initialized
+	if ( !FSlateApplication::IsInitialized() )
+	{
+		return;
+	}
+
+	if ( WidgetClass && Instance.Widget == nullptr && GetWorld() )
+	{
+		Instance.Widget = CreateWidget<UUserWidget>(GetWorld(), WidgetClass);
+
+#if WITH_EDITOR
+		if ( Instance.Widget && !GetWorld()->IsGameWorld() && !GEnableVREditorHacks )
+		{
+			// Prevent native ticking of editor component previews
+			Instance.Widget->SetDesignerFlags(EWidgetDesignFlags::Designing);
+		}
+#endif
+	}
+
+	if ( !Instance.SlateWindow.IsValid() )
+	{
+		Instance.SlateWindow = SNew(SVirtualWindow).Size(DrawSize);
+		Instance.SlateWindow->SetIsFocusable(bWindowFocusable);
+
+		// Keep the content from spilling into the regions of the other instances
+		Instance.SlateWindow->SetClipping(EWidgetClipping::ClipToBounds);
+
+		FSlateApplication::Get().RegisterVirtualWindow(Instance.SlateWindow.ToSharedRef());
+	}
+
+	if ( !Instance.HitTestGrid.IsValid() )
+	{
+		Instance.HitTestGrid = MakeShareable(new FHittestGrid);
+	}
+
+	Instance.SlateWindow->SetContent(Instance.Widget ? Instance.Widget->TakeWidget() : SNullWidget::NullWidget);
+	Instance.bRedrawRequested = true;
+}
+
+void UInstancedMeshWidgetComponent::ReleaseInstance(FMeshWidgetInstance& Instance)
+{
+	if ( Instance.SlateWindow.IsValid() )
+	{
+		if ( FSlateApplication::IsInitialized() )
+		{
+			FSlateApplication::Get().UnregisterVirtualWindow(Instance.SlateWindow.ToSharedRef());
+		}
+
+		Instance.SlateWindow.Reset();
+	}
+
+	Instance.HitTestGrid.Reset();
+	Instance.Widget = nullptr;
+
+	if ( Instance.AtlasRegion.Area() > 0 )
+	{
+		AtlasAllocator.Release(Instance.AtlasRegion);
+		Instance.AtlasRegion = FIntRect();
+	}
+}
+
+void UInstancedMeshWidgetComponent::SyncInstances()
+{
+	const int32 NumInstances = GetInstanceCount();
+
+	while ( Instances.Num() > NumInstances )
+	{
+		ReleaseInstance(Instances.Last());
+		Instances.Pop();
+	}
+
+	while ( Instances.Num() < NumInstances )
+	{
+		InitInstance(Instances.AddDefaulted_GetRef());
+	}
+
+	bAtlasLayoutDirty = true;
+}
+
+void UInstancedMeshWidgetComponent::UpdateAtlasLayout()
+{
+	using namespace InstancedMeshWidget;
+
+	if ( !bAtlasLayoutDirty || GUsingNullRHI || DrawSize.X <= 0 || DrawSize.Y <= 0 )
+	{
+		return;
+	}
+
+	bAtlasLayoutDirty = false;
+
+	bool bAtlasResized = false;
+	int32 NumWithoutRegion = 0;
+
+	for ( FMeshWidgetInstance& Instance : Instances )
+	{
+		// Regions from before a draw size change have the wrong size
+		if ( Instance.AtlasRegion.Area() > 0 && Instance.AtlasRegion.Size() != DrawSize )
+		{
+			AtlasAllocator.Release(Instance.AtlasRegion);
+			Instance.AtlasRegion = FIntRect();
+		}
+
+		if ( Instance.AtlasRegion.Area() > 0 )
+		{
+			continue;
+		}
+
+		if ( RenderTarget == nullptr )
+		{
+			const int32 AtlasSize = FMath::Max<int32>(InitialAtlasSize, FMath::RoundUpToPowerOfTwo(FMath::Max(DrawSize.X, DrawSize.Y)));
+
+			AtlasAllocator = FMeshWidgetAtlasAllocator(FIntPoint(AtlasSize, AtlasSize));
+			AcquireAtlasRenderTarget(AtlasAllocator.GetSize());
+		}
+
+		while ( !AtlasAllocator.Allocate(DrawSize, Instance.AtlasRegion) )
+		{
+			if ( AtlasAllocator.GetSize().X >= MaxAtlasSize )
+			{
+				Instance.AtlasRegion = FIntRect();
+				NumWithoutRegion++;
+				break;
+			}
+
+			AtlasAllocator.Resize(AtlasAllocator.GetSize() * 2);
+			bAtlasResized = true;
+		}
+
+		Instance.bRedrawRequested = true;
+	}
+
+	if ( bAtlasResized )
+	{
+		// Resizing loses the contents of every region
+		AcquireAtlasRenderTarget(AtlasAllocator.GetSize());
+		RequestRedraw();
+	}
+
+	if ( NumWithoutRegion > 0 )
+	{
+		UE_LOG(LogMeshWidget, Warning, TEXT("%s: %d instances don't fit in a %dx%d atlas and show no widget.  Lower the DrawSize or split the instances."),
+			*GetPathName(), NumWithoutRegion, MaxAtlasSize, MaxAtlasSize);
+	}
+
+	UpdateInstanceCustomData();
+}
+
+void UInstancedMeshWidgetComponent::UpdateInstanceCustomData()
+{
+	using namespace InstancedMeshWidget;
+
+	// The regions take the first floats, which the instance data has to have room for
+	if ( NumCustomDataFloats < AtlasCustomDataFloats )
+	{
+		NumCustomDataFloats = AtlasCustomDataFloats;
+		PerInstanceSMCustomData.Reset();
+	}
+	PerInstanceSMCustomData.SetNumZeroed(GetInstanceCount() * NumCustomDataFloats);
+
+	const FVector2D AtlasSize(FMath::Max(1, AtlasAllocator.GetSize().X), FMath::Max(1, AtlasAllocator.GetSize().Y));
+
+	for ( int32 InstanceIndex = 0; InstanceIndex < Instances.Num(); ++InstanceIndex )
+	{
+		const FIntRect& Region = Instances[InstanceIndex].AtlasRegion;
+
+		SetCustomDataValue(InstanceIndex, 0, Region.Width() / AtlasSize.X);
+		SetCustomDataValue(InstanceIndex, 1, Region.Height() / AtlasSize.Y);
+		SetCustomDataValue(InstanceIndex, 2, Region.Min.X / AtlasSize.X);
+		SetCustomDataValue(InstanceIndex, 3, Region.Min.Y / AtlasSize.Y);
+	}
+
+	// One render state update for all the instances
+	MarkRenderStateDirty();
+}
+
+void UInstancedMeshWidgetComponent::AcquireAtlasRenderTarget(FIntPoint AtlasSize)
+{
+	ReleaseAtlasRenderTarget();
+
+	if ( UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() )
+	{
+		RenderTarget = Subsystem->GetRenderTargetPool()->Acquire(FMeshWidgetRenderTargetDesc(AtlasSize, PF_B8G8R8A8, false, FLinearColor::Transparent));
+	}
+	else
+	{
+		RenderTarget = NewObject<UTextureRenderTarget2D>(this);
+		RenderTarget->ClearColor = FLinearColor::Transparent;
+		RenderTarget->InitCustomFormat(AtlasSize.X, AtlasSize.Y, PF_B8G8R8A8, false);
+	}
+
+	if ( MaterialInstance )
+	{
+		MaterialInstance->SetTextureParameterValue(InstancedMeshWidget::SlateUI, RenderTarget);
+	}
+}
+
+void UInstancedMeshWidgetComponent::ReleaseAtlasRenderTarget()
+{
+	UWorld* World = GetWorld();
+	if ( UMeshWidgetSubsystem* Subsystem = RenderTarget && World ? World->GetSubsystem<UMeshWidgetSubsystem>() : nullptr )
+	{
+		Subsystem->GetRenderTargetPool()->Release(RenderTarget);
+	}
+
+	RenderTarget = nullptr;
+}
+
+void UInstancedMeshWidgetComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if ( Instances.Num() != GetInstanceCount() )
+	{
+		SyncInstances();
+	}
+
+	UpdateAtlasLayout();
+
+	NumRedrawsLastFrame = 0;
+
+	if ( !WidgetRenderer.IsValid() || RenderTarget == nullptr || !IsVisible() )
+	{
+		return;
+	}
+
+	TArray<int32> DueInstances;
+	for ( int32 InstanceIndex = 0; InstanceIndex < Instances.Num(); ++InstanceIndex )
+	{
+		if ( ShouldDrawInstance(InstanceIndex) )
+		{
+			DueInstances.Add(InstanceIndex);
+		}
+	}
+
+	if ( MaxRedrawsPerFrame > 0 && DueInstances.Num() > MaxRedrawsPerFrame )
+	{
+		// Requested redraws first, then the instances that waited longest
+		DueInstances.Sort([this](int32 A, int32 B)
+		{
+			const FMeshWidgetInstance& InstanceA = Instances[A];
+			const FMeshWidgetInstance& InstanceB = Instances[B];
+			if ( InstanceA.bRedrawRequested != InstanceB.bRedrawRequested )
+			{
+				return InstanceA.bRedrawRequested;
+			}
+			return InstanceA.LastWidgetRenderTime < InstanceB.LastWidgetRenderTime;
+		});
+
+		DueInstances.SetNum(MaxRedrawsPerFrame);
+	}
+
+	// Let the world's scheduler decide which instances fit in the frame budget, along with the other mesh widgets
+	UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>();
+	for ( int32 InstanceIndex : DueInstances )
+	{
+		if ( Subsystem )
+		{
+			Subsystem->RequestRedrawSlot(this, InstanceIndex);
+		}
+		else
+		{
+			DrawInstanceToRenderTarget(InstanceIndex, DeltaTime);
+			NumRedrawsLastFrame++;
+		}
+	}
+}
+
+bool UInstancedMeshWidgetComponent::DrawScheduledInstance(int32 InstanceIndex, float DeltaTime)
+{
+	// Instances may have been removed, or the atlas released, since the instance asked
+	if ( !WidgetRenderer.IsValid() || RenderTarget == nullptr || !Instances.IsValidIndex(InstanceIndex) || !ShouldDrawInstance(InstanceIndex) )
+	{
+		return false;
+	}
+
+	DrawInstanceToRenderTarget(InstanceIndex, DeltaTime);
+	NumRedrawsLastFrame++;
+
+	return true;
+}
+
+bool UInstancedMeshWidgetComponent::ShouldDrawInstance(int32 InstanceIndex) const
+{
+	const FMeshWidgetInstance& Instance = Instances[InstanceIndex];
+	if ( !Instance.SlateWindow.IsValid() || Instance.AtlasRegion.Area() <= 0 )
+	{
+		return false;
+	}
+
+	// Requested redraws don't wait for RedrawTime, they are what keeps a hovered instance responsive.  Scalability
+	// may cap the redraw rate
+	const float MaxScalabilityRate = MeshWidgetScalability::GetMaxRedrawRate();
+	const float EffectiveRedrawTime = MaxScalabilityRate > 0.0f ? FMath::Max(RedrawTime, 1.0f / MaxScalabilityRate) : RedrawTime;
+	if ( !Instance.bRedrawRequested && GetWorld()->TimeSince(Instance.LastWidgetRenderTime) < EffectiveRedrawTime )
+	{
+		return false;
+	}
+
+	if ( TickWhenOffscreen )
+	{
+		return true;
+	}
+
+	UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>();
+	switch ( Subsystem ? Subsystem->GetViewVisibility(GetInstanceBounds(InstanceIndex)) : EMeshWidgetViewVisibility::Unknown )
+	{
+	case EMeshWidgetViewVisibility::InView:
+	case EMeshWidgetViewVisibility::NearView:
+		return true;
+	case EMeshWidgetViewVisibility::Hidden:
+		return false;
+	default:
+	{
+		// Without player views (editor viewports, no local players) fall back to the last render time
+		const float RenderTimeThreshold = .5f;
+		return GetWorld()->TimeSince(GetLastRenderTime()) <= RenderTimeThreshold;
+	}
+	}
+}
+
+void UInstancedMeshWidgetComponent::DrawInstanceToRenderTarget(int32 InstanceIndex, float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetDrawWidget);
+	MESHWIDGET_SCOPED_NAMED_EVENT("MeshWidget Draw Instance", this);
+
+	FMeshWidgetInstance& Instance = Instances[InstanceIndex];
+
+	Instance.SlateWindow->Resize(DrawSize);
+
+	MeshWidgetRendering::ClearRenderTargetRegion(RenderTarget, Instance.AtlasRegion, BackgroundColor);
+
+	const FGeometry WindowGeometry = FGeometry::MakeRoot(FVector2D(DrawSize), FSlateLayoutTransform(FVector2D(Instance.AtlasRegion.Min)));
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_MeshWidgetDrawWindow);
+		WidgetRenderer->DrawWindow(
+			RenderTarget,
+			Instance.HitTestGrid.ToSharedRef().Get(),
+			Instance.SlateWindow.ToSharedRef(),
+			WindowGeometry,
+			DeltaTime,
+			false);
+	}
+
+	INC_DWORD_STAT(STAT_MeshWidgetNumRedraws);
+
+	Instance.LastWidgetRenderTime = GetWorld()->TimeSeconds;
+	Instance.bRedrawRequested = false;
+}
+
+FBoxSphereBounds UInstancedMeshWidgetComponent::GetInstanceBounds(int32 InstanceIndex) const
+{
+	FTransform InstanceTransform;
+	if ( GetStaticMesh() == nullptr || !GetInstanceTransform(InstanceIndex, InstanceTransform, /*bWorldSpace*/ true) )
+	{
+		return Bounds;
+	}
+
+	return GetStaticMesh()->GetBounds().TransformBy(InstanceTransform);
+}
+
+UUserWidget* UInstancedMeshWidgetComponent::GetInstanceWidget(int32 InstanceIndex) const
+{
+	return Instances.IsValidIndex(InstanceIndex) ? Instances[InstanceIndex].Widget : nullptr;
+}
+
+void UInstancedMeshWidgetComponent::SetInstanceWidget(int32 InstanceIndex, UUserWidget* InWidget)
+{
+	if ( Instances.IsValidIndex(InstanceIndex) )
+	{
+		FMeshWidgetInstance& Instance = Instances[InstanceIndex];
+		Instance.Widget = InWidget;
+
+		if ( Instance.SlateWindow.IsValid() )
+		{
+			Instance.SlateWindow->SetContent(InWidget ? InWidget->TakeWidget() : SNullWidget::NullWidget);
+		}
+
+		Instance.bRedrawRequested = true;
+	}
+}
+
+void UInstancedMeshWidgetComponent::RequestInstanceRedraw(int32 InstanceIndex)
+{
+	if ( Instances.IsValidIndex(InstanceIndex) )
+	{
+		Instances[InstanceIndex].bRedrawRequested = true;
+	}
+}
+
+void UInstancedMeshWidgetComponent::RequestRedraw()
+{
+	for ( FMeshWidgetInstance& Instance : Instances )
+	{
+		Instance.bRedrawRequested = true;
+	}
+}
+
+FVector2D UInstancedMeshWidgetComponent::GetLocalHitLocation(const FHitResult& Hit) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetGetLocalHitLocation);
+
+	FVector2D UV(0.0f, 0.0f);
+
+	// The collision UVs are in the space of the mesh, so the hit has to be brought into the space of the instance
+	FTransform InstanceTransform;
+	const UBodySetup* BodySetup = GetStaticMesh() ? GetStaticMesh()->BodySetup : nullptr;
+	if ( BodySetup && GetInstanceTransform(Hit.Item, InstanceTransform, /*bWorldSpace*/ true) )
+	{
+		BodySetup->CalcUVAtLocation(InstanceTransform.InverseTransformPosition(Hit.Location), Hit.FaceIndex, 0, UV);
+	}
+
+	return FVector2D(DrawSize.X * UV.X, DrawSize.Y * UV.Y);
+}
+
+FVector2D UInstancedMeshWidgetComponent::LocalToWindowLocation(int32 InstanceIndex, const FVector2D& LocalLocation) const
+{
+	return Instances.IsValidIndex(InstanceIndex) ? LocalLocation + FVector2D(Instances[InstanceIndex].AtlasRegion.Min) : LocalLocation;
+}
+
+TArray<FWidgetAndPointer> UInstancedMeshWidgetComponent::GetHitWidgetPath(const FHitResult& Hit, bool bIgnoreEnabledStatus, float CursorRadius)
+{
+	TArray<FWidgetAndPointer> ArrangedWidgets;
+
+	const int32 InstanceIndex = Hit.Item;
+	if ( !Instances.IsValidIndex(InstanceIndex) || !Instances[InstanceIndex].HitTestGrid.IsValid() )
+	{
+		return ArrangedWidgets;
+	}
+
+	const FVector2D LocalHitLocation = GetLocalHitLocation(Hit);
+	const FVector2D WindowHitLocation = LocalToWindowLocation(InstanceIndex, LocalHitLocation);
+
+	TSharedRef<FVirtualPointerPosition> VirtualMouseCoordinate = MakeShareable( new FVirtualPointerPosition );
+
+	VirtualMouseCoordinate->CurrentCursorPosition = WindowHitLocation;
+
+	// A pointer coming from another instance has no meaningful last position on this one
+	VirtualMouseCoordinate->LastCursorPosition = InstanceIndex == LastHitInstanceIndex ? LocalToWindowLocation(InstanceIndex, LastLocalHitLocation) : WindowHitLocation;
+
+	// Cache the location of the hit
+	LastHitInstanceIndex = InstanceIndex;
+	LastLocalHitLocation = LocalHitLocation;
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_MeshWidgetGetBubblePath);
+		ArrangedWidgets = Instances[InstanceIndex].HitTestGrid->GetBubblePath( WindowHitLocation, CursorRadius, bIgnoreEnabledStatus );
+	}
+
+	for( FWidgetAndPointer& ArrangedWidget : ArrangedWidgets )
+	{
+		ArrangedWidget.PointerPosition = VirtualMouseCoordinate;
+	}
+
+	return ArrangedWidgets;
+}
+
+void UInstancedMeshWidgetComponent::SetBackgroundColor( const FLinearColor NewBackgroundColor )
+{
+	if ( NewBackgroundColor != BackgroundColor )
+	{
+		BackgroundColor = NewBackgroundColor;
+
+		if ( MaterialInstance )
+		{
+			MaterialInstance->SetVectorParameterValue(InstancedMeshWidget::BackColor, BackgroundColor);
+		}
+
+		RequestRedraw();
+	}
+}
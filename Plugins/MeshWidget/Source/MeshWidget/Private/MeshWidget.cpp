@@ -1,6 +1,10 @@
 // Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
 
 #include "IMeshWidget.h"
+#include "MeshWidgetStats.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Paths.h"
 
 class FMeshWidget : public IMeshWidget
 {
@@ -11,11 +15,67 @@ class FMeshWidget : public IMeshWidget
 
 IMPLEMENT_MODULE( FMeshWidget, MeshWidget )
 
+DEFINE_LOG_CATEGORY(LogMeshWidget);
+
+DEFINE_STAT(STAT_MeshWidgetSubsystemTick);
+DEFINE_STAT(STAT_MeshWidgetDrawWidget);
+DEFINE_STAT(STAT_MeshWidgetUpdateWidget);
+DEFINE_STAT(STAT_MeshWidgetSlatePrepass);
+DEFINE_STAT(STAT_MeshWidgetDrawWindow);
+DEFINE_STAT(STAT_MeshWidgetUpdateRenderTarget);
+DEFINE_STAT(STAT_MeshWidgetUpdateMaterialParameters);
+DEFINE_STAT(STAT_MeshWidgetPerformTrace);
+DEFINE_STAT(STAT_MeshWidgetGetLocalHitLocation);
+DEFINE_STAT(STAT_MeshWidgetGetBubblePath);
+DEFINE_STAT(STAT_MeshWidgetRoutePointerMoveEvent);
+DEFINE_STAT(STAT_MeshWidgetRoutePointerDownEvent);
+DEFINE_STAT(STAT_MeshWidgetRoutePointerUpEvent);
+DEFINE_STAT(STAT_MeshWidgetRouteMouseWheelEvent);
+DEFINE_STAT(STAT_MeshWidgetNumRedraws);
+DEFINE_STAT(STAT_MeshWidgetNumPartialRedraws);
+DEFINE_STAT(STAT_MeshWidgetNumPendingRedraws);
+DEFINE_STAT(STAT_MeshWidgetNumMaterialParametersSet);
+
 
 
 void FMeshWidget::StartupModule()
 {
-	// This code will execute after your module is loaded into memory (but after global variables are initialized, of course.)
+	// memreport only runs the commands of the engine config and scalability groups only read the scalability
+	// config, so the plugin's config is merged into them.  The sections aren't marked dirty, nothing is written
+	// to the saved config
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("MeshWidget"));
+	if ( !Plugin.IsValid() || GConfig == nullptr )
+	{
+		return;
+	}
+
+	// Combine, unlike Read, resolves the +/- array prefixes of the file
+	FConfigFile PluginConfig;
+	PluginConfig.Combine(FPaths::Combine(Plugin->GetBaseDir(), TEXT("Config"), TEXT("DefaultMeshWidget.ini")));
+
+	if ( FConfigFile* EngineConfig = GConfig->FindConfigFile(GEngineIni) )
+	{
+		TArray<FString> Commands;
+		PluginConfig.GetArray(TEXT("MemReportCommands"), TEXT("Cmd"), Commands);
+
+		FConfigSection& MemReportCommands = EngineConfig->FindOrAdd(TEXT("MemReportCommands"));
+		for ( const FString& Command : Commands )
+		{
+			MemReportCommands.AddUnique(TEXT("Cmd"), FConfigValue(Command));
+		}
+	}
+
+	// The [MeshWidgetQuality@N] sections of sg.MeshWidgetQuality, a project that has its own keeps them
+	if ( FConfigFile* ScalabilityConfig = GConfig->FindConfigFile(GScalabilityIni) )
+	{
+		for ( const TPair<FString, FConfigSection>& Section : PluginConfig )
+		{
+			if ( Section.Key.StartsWith(TEXT("MeshWidgetQuality@")) && ScalabilityConfig->Find(Section.Key) == nullptr )
+			{
+				ScalabilityConfig->Add(Section.Key, Section.Value);
+			}
+		}
+	}
 }
 
 
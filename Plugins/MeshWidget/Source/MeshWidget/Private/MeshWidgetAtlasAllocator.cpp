@@ -0,0 +1,182 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "MeshWidgetAtlasAllocator.h"
+
+namespace MeshWidgetAtlasAllocator
+{
+	/** A shelf may be used by regions down to this fraction of its height before a new shelf is preferred */
+	const float MinShelfFill = 0.7f;
+}
+
+FMeshWidgetAtlasAllocator::FMeshWidgetAtlasAllocator(FIntPoint InSize, int32 InPadding)
+	: Size(InSize)
+	, Padding(InPadding)
+	, NumRegions(0)
+	, AllocatedArea(0)
+{
+}
+
+bool FMeshWidgetAtlasAllocator::Allocate(FIntPoint RegionSize, FIntRect& OutRegion)
+{
+	const int32 Width = RegionSize.X + Padding;
+	const int32 Height = RegionSize.Y + Padding;
+
+	if ( RegionSize.X <= 0 || RegionSize.Y <= 0 || Width > Size.X || Height > Size.Y )
+	{
+		return false;
+	}
+
+	// Prefer the tightest existing shelf that doesn't waste too much height
+	int32 BestShelf = INDEX_NONE;
+	int32 BestSpan = INDEX_NONE;
+	for ( int32 ShelfIndex = 0; ShelfIndex < Shelves.Num(); ++ShelfIndex )
+	{
+		const FShelf& Shelf = Shelves[ShelfIndex];
+		if ( Shelf.Height < Height || Height < Shelf.Height * MeshWidgetAtlasAllocator::MinShelfFill )
+		{
+			continue;
+		}
+
+		if ( BestShelf != INDEX_NONE && Shelves[BestShelf].Height <= Shelf.Height )
+		{
+			continue;
+		}
+
+		const int32 SpanIndex = FindFreeSpan(Shelf, Width);
+		if ( SpanIndex != INDEX_NONE )
+		{
+			BestShelf = ShelfIndex;
+			BestSpan = SpanIndex;
+		}
+	}
+
+	if ( BestShelf != INDEX_NONE )
+	{
+		OutRegion = AllocateFromShelf(Shelves[BestShelf], BestSpan, RegionSize, Width);
+		return true;
+	}
+
+	// Open a new shelf below the last one
+	const int32 NextShelfY = Shelves.Num() > 0 ? Shelves.Last().Y + Shelves.Last().Height : 0;
+	if ( NextShelfY + Height <= Size.Y )
+	{
+		FShelf& Shelf = Shelves.AddDefaulted_GetRef();
+		Shelf.Y = NextShelfY;
+		Shelf.Height = Height;
+		Shelf.FreeSpans.Add(FIntPoint(0, Size.X));
+
+		OutRegion = AllocateFromShelf(Shelf, 0, RegionSize, Width);
+		return true;
+	}
+
+	// Out of height, accept any shelf the region fits in
+	for ( FShelf& Shelf : Shelves )
+	{
+		if ( Shelf.Height >= Height )
+		{
+			const int32 SpanIndex = FindFreeSpan(Shelf, Width);
+			if ( SpanIndex != INDEX_NONE )
+			{
+				OutRegion = AllocateFromShelf(Shelf, SpanIndex, RegionSize, Width);
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void FMeshWidgetAtlasAllocator::Release(const FIntRect& Region)
+{
+	const int32 ShelfIndex = Shelves.IndexOfByPredicate([&Region](const FShelf& Shelf) { return Shelf.Y == Region.Min.Y; });
+	if ( !ensure(ShelfIndex != INDEX_NONE) )
+	{
+		return;
+	}
+
+	FShelf& Shelf = Shelves[ShelfIndex];
+
+	Shelf.FreeSpans.Add(FIntPoint(Region.Min.X, Region.Width() + Padding));
+	Shelf.FreeSpans.Sort([](const FIntPoint& A, const FIntPoint& B) { return A.X < B.X; });
+
+	// Merge touching spans
+	for ( int32 SpanIndex = Shelf.FreeSpans.Num() - 1; SpanIndex > 0; --SpanIndex )
+	{
+		FIntPoint& Previous = Shelf.FreeSpans[SpanIndex - 1];
+		const FIntPoint& Current = Shelf.FreeSpans[SpanIndex];
+		if ( Previous.X + Previous.Y == Current.X )
+		{
+			Previous.Y += Current.Y;
+			Shelf.FreeSpans.RemoveAt(SpanIndex, 1, false);
+		}
+	}
+
+	NumRegions--;
+	AllocatedArea -= (int64)Region.Width() * Region.Height();
+
+	// Give the height of empty shelves at the bottom back to the atlas
+	while ( Shelves.Num() > 0 )
+	{
+		const FShelf& LastShelf = Shelves.Last();
+		if ( LastShelf.FreeSpans.Num() == 1 && LastShelf.FreeSpans[0] == FIntPoint(0, Size.X) )
+		{
+			Shelves.Pop(false);
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+void FMeshWidgetAtlasAllocator::Resize(FIntPoint NewSize)
+{
+	check(NewSize.X >= Size.X && NewSize.Y >= Size.Y);
+
+	const int32 AddedWidth = NewSize.X - Size.X;
+	if ( AddedWidth > 0 )
+	{
+		for ( FShelf& Shelf : Shelves )
+		{
+			if ( Shelf.FreeSpans.Num() > 0 && Shelf.FreeSpans.Last().X + Shelf.FreeSpans.Last().Y == Size.X )
+			{
+				Shelf.FreeSpans.Last().Y += AddedWidth;
+			}
+			else
+			{
+				Shelf.FreeSpans.Add(FIntPoint(Size.X, AddedWidth));
+			}
+		}
+	}
+
+	Size = NewSize;
+}
+
+float FMeshWidgetAtlasAllocator::GetUsage() const
+{
+	const int64 Area = (int64)Size.X * Size.Y;
+	return Area > 0 ? (float)((double)AllocatedArea / Area) : 0.0f;
+}
+
+int32 FMeshWidgetAtlasAllocator::FindFreeSpan(const FShelf& Shelf, int32 Width)
+{
+	return Shelf.FreeSpans.IndexOfByPredicate([Width](const FIntPoint& Span) { return Span.Y >= Width; });
+}
+
+FIntRect FMeshWidgetAtlasAllocator::AllocateFromShelf(FShelf& Shelf, int32 SpanIndex, FIntPoint RegionSize, int32 Width)
+{
+	FIntPoint& Span = Shelf.FreeSpans[SpanIndex];
+	const FIntRect Region(FIntPoint(Span.X, Shelf.Y), FIntPoint(Span.X + RegionSize.X, Shelf.Y + RegionSize.Y));
+
+	Span.X += Width;
+	Span.Y -= Width;
+	if ( Span.Y == 0 )
+	{
+		Shelf.FreeSpans.RemoveAt(SpanIndex, 1, false);
+	}
+
+	NumRegions++;
+	AllocatedArea += (int64)RegionSize.X * RegionSize.Y;
+
+	return Region;
+}
@@ -1,16 +1,26 @@
 // Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
 
 #include "MeshWidgetComponent.h"
+#include "IMeshWidget.h"
+#include "MeshWidgetSubsystem.h"
+#include "MeshWidgetRendering.h"
+#include "MeshWidgetRenderTargetPool.h"
+#include "MeshWidgetSignature.h"
+#include "MeshWidgetDirtyRegion.h"
+#include "MeshWidgetInvalidationPanel.h"
+#include "MeshWidgetLODInterface.h"
+#include "MeshWidgetScalability.h"
+#include "MeshWidgetStats.h"
 
 #include "SlateCore/Public/Input/HittestGrid.h"
 #include "Runtime/SlateRHIRenderer/Public/Interfaces/ISlateRHIRendererModule.h"
 #include "Runtime/SlateRHIRenderer/Public/Interfaces/ISlate3DRenderer.h"
 #include "DynamicMeshBuilder.h"
-#include "Scalability.h"
 #include "UMG/Public/Blueprint/WidgetLayoutLibrary.h"
 #include "PhysicsEngine/BodySetup.h"
 #include "Slate/WidgetRenderer.h"
 #include "Widgets/Layout/SPopup.h"
+#include "Widgets/Text/STextBlock.h"
 #include "StaticMeshResources.h"
 #include "Kismet/GameplayStatics.h"
 #include "Runtime/CoreUObject/Public/UObject/ConstructorHelpers.h"
@@ -19,28 +29,92 @@
 #include "Runtime/Engine/Classes/Engine/TextureRenderTarget2D.h"
 #include "Runtime/SlateCore/Public/Widgets/SWidget.h"
 #include "Runtime/UMG/Public/Blueprint/UserWidget.h"
+#include "Runtime/UMG/Public/Blueprint/WidgetTree.h"
 #include "Runtime/RenderCore/Public/RenderingThread.h"
 #include "Components/SceneComponent.h"
 
-
-DECLARE_CYCLE_STAT(TEXT("3DHitTesting"), STAT_Slate3DHitTesting, STATGROUP_Slate);
+namespace MeshWidgetMaterialParameters
+{
+	static const FName SlateUI(TEXT("SlateUI"));
+	static const FName BackColor(TEXT("BackColor"));
+	static const FName TintColorAndOpacity(TEXT("TintColorAndOpacity"));
+	static const FName OpacityFromTexture(TEXT("OpacityFromTexture"));
+	static const FName ParabolaDistortion(TEXT("ParabolaDistortion"));
+	static const FName AtlasUVScaleOffset(TEXT("AtlasUVScaleOffset"));
+	static const FName CursorTexture(TEXT("CursorTexture"));
+	static const FName CursorUV(TEXT("CursorUV"));
+	static const FName CursorSize(TEXT("CursorSize"));
+}
 
 UMeshWidgetComponent::UMeshWidgetComponent( const FObjectInitializer& PCIP )
 	: Super( PCIP )
 	, DrawSize( FIntPoint( 500, 500 ) )
 	, bManuallyRedraw(false)
+	, bRedrawOnlyWhenChanged(false)
+	, MaxUnchangedRedrawInterval(1.0f)
+	, bUseDirtyRegions(false)
+	, DirtyRegionFullRepaintThreshold(0.5f)
+	, DirtyRegionFullRepaintInterval(1.0f)
+	, bUseInvalidationPanel(false)
 	, bRedrawRequested(true)
 	, RedrawTime(0)
+	, bAdaptiveRedrawRate(false)
+	, MinRedrawRate(2.0f)
+	, MaxRedrawRate(60.0f)
+	, RedrawSignificance(1.0f)
 	, LastWidgetRenderTime(0)
+	, NumRedraws(0)
+	, LastHoveredFrame(0)
+	, LastDrawnWidgetSignature(0)
+	, WidgetTreeSignature(0)
+	, WidgetTreeSignatureFrame(MAX_uint64)
+	, bThawOnHover(true)
+	, bFrozen(false)
+	, bDeferWidgetCreation(false)
+	, ReleaseWhenUnseenTime(0.0f)
+	, bWidgetDormant(false)
+	, LastNeededTime(0.0f)
+	, WidgetClassLOD(0)
+	, bFrozenByClassLOD(false)
+	, bFrozenByLiveWidgetLimit(false)
+	, bFreezePending(false)
+	, bRenderTargetEvicted(false)
+	, LODState(nullptr)
+	, MirrorSource(nullptr)
 	, bWindowFocusable(true)
+	, bHasDesiredSizePrepass(false)
+	, DesiredSizePrepassSignature(0)
+	, DesiredSizePrepassScale(1.0f)
+	, DesiredSizePrepassTime(0.0f)
+	, bUseResolutionLOD(false)
+	, MaxResolutionLOD(3)
+	, ResolutionLOD(0)
+	, CurrentDrawScale(1.0f)
 	, BackgroundColor( FLinearColor::Transparent )
 	, TintColorAndOpacity( FLinearColor::White )
 	, OpacityFromTexture( 1.0f )
 	, BlendMode( EWidgetBlendMode::Masked )
 	, bIsOpaque_DEPRECATED( false )
+	, RenderTargetFormat( EMeshWidgetRenderTargetFormat::RGBA8 )
+	, bForceLinearGamma( false )
+	, SingleChannelMaterial( nullptr )
+	, RenderTargetPixelFormat( PF_B8G8R8A8 )
+	, MipGeneration( EMeshWidgetMipGeneration::None )
+	, MipFilter( TF_Trilinear )
+	, LastMipsWidgetSignature( 0 )
+	, bMipsDirty( true )
+	, bUseSharedAtlas( false )
+	, AtlasMaterial( nullptr )
 	, bIsTwoSided( false )
 	, ParabolaDistortion( 0 )
+	, bUseMaterialCursor( false )
+	, CursorTexture( nullptr )
+	, CursorSize( 32.0f, 32.0f )
+	, CursorUV( FLinearColor::Transparent )
 	, TickWhenOffscreen( false )
+	, bSkipRedrawWhenOccluded( false )
+	, ViewVisibility( EMeshWidgetViewVisibility::Unknown )
+	, bOccluded( false )
 {
 	PrimaryComponentTick.bCanEverTick = true;
 	bTickInEditor = true;
@@ -76,10 +150,22 @@ UMeshWidgetComponent::UMeshWidgetComponent( const FObjectInitializer& PCIP )
 	Pivot = FVector2D(0.5, 0.5);
 
     bAddedToScreen = false;
+
+	bDrawingToSharedAtlas = false;
+	RenderTargetRegion = FIntRect();
+	RenderTargetAllocation = FIntRect();
+	RetiredRenderTarget = nullptr;
+	bRenderTargetSwapFenceBegun = false;
+	MaterialInstanceBase = nullptr;
+
+	bFullRepaintNeeded = true;
+	LastFullRepaintTime = 0.0f;
+	LastRedrawCoverage = 1.0f;
 }
 
 void UMeshWidgetComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	UnlinkMirrors();
 	ReleaseResources();
 	Super::EndPlay(EndPlayReason);
 }
@@ -88,12 +174,31 @@ void UMeshWidgetComponent::OnRegister()
 {
 	Super::OnRegister();
 
-	if (!WidgetRenderer.IsValid() && !GUsingNullRHI)
+	// Nothing is created until the widget is seen, only the mesh is rendered
+	if ( bDeferWidgetCreation && !bFrozen && !MirrorSource && Widget == nullptr )
+	{
+		bWidgetDormant = true;
+	}
+
+	if (!WidgetRenderer.IsValid() && !GUsingNullRHI && !bFrozen && !MirrorSource && !bWidgetDormant)
     {
         WidgetRenderer = MakeShareable(new FWidgetRenderer());
     }
 
-    InitWidget();
+	if ( UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() )
+	{
+		Subsystem->RegisterComponent(this);
+	}
+
+	ValidateRenderTargetFormat();
+	ValidateMaterialCursor();
+
+	LastNeededTime = GetWorld()->TimeSeconds;
+
+	if ( !bFrozen && !MirrorSource && !bWidgetDormant )
+	{
+		InitWidget();
+	}
 }
 
 void UMeshWidgetComponent::OnUnregister()
@@ -105,6 +210,11 @@ void UMeshWidgetComponent::OnUnregister()
 	}
 #endif
 
+	if ( UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() )
+	{
+		Subsystem->UnregisterComponent(this);
+	}
+
 	Super::OnUnregister();
 }
 
@@ -112,16 +222,26 @@ void UMeshWidgetComponent::DestroyComponent(bool bPromoteChildren/*= false*/)
 {
 	Super::DestroyComponent(bPromoteChildren);
 
+	UnlinkMirrors();
 	ReleaseResources();
 }
 
 FPrimitiveSceneProxy* UMeshWidgetComponent::CreateSceneProxy()
 {
-	if ( WidgetRenderer.IsValid() )
+	// The proxy only needs the material, so it doesn't wait for the widget renderer: a dormant widget shows its
+	// mesh until it is seen, a frozen widget its texture, and a mirror the texture of its source
+	if ( !GUsingNullRHI || bFrozen || MirrorSource )
 	{
-		// Create a new MID for the current base material
+		// Reuse the MID of the current base material, the parameter cache knows what it was last given
 		UMaterialInterface* BaseMaterial = GetBaseMaterial();
-		MaterialInstance = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+		FMeshWidgetMaterialInstance& CachedInstance = MaterialInstanceCache.FindOrAdd(BaseMaterial);
+		if ( CachedInstance.Instance == nullptr )
+		{
+			CachedInstance.Instance = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+		}
+
+		MaterialInstance = CachedInstance.Instance;
+		MaterialInstanceBase = BaseMaterial;
 		UpdateMaterialInstanceParameters();
 
         if (OverrideMaterials.Num() == 0)
@@ -147,435 +267,1930 @@ void UMeshWidgetComponent::ReleaseResources()
 		Widget = nullptr;
 	}
 
+	ReleaseSlateResources();
+	ReleaseRenderTarget();
+
+	bFrozen = false;
+	bFrozenByClassLOD = false;
+	bFrozenByLiveWidgetLimit = false;
+	bFreezePending = false;
+	bRenderTargetEvicted = false;
+	bWidgetDormant = false;
+	WidgetClassLOD = 0;
+	LODState = nullptr;
+	LODStateWidgetClass = nullptr;
+}
+
+void UMeshWidgetComponent::ReleaseSlateResources()
+{
 	WidgetRenderer.Reset();
 	HitTestGrid.Reset();
+	PartialHitTestGrid.Reset();
+	DirtyRegionHost.Reset();
+	DirtyRegionTracker.Reset();
+	InvalidationPanel.Reset();
+	SignatureTextCache.Reset();
+	InvalidateWidgetSignature();
+	bFullRepaintNeeded = true;
 
 	UnregisterWindow();
+
+	CurrentSlateWidget.Reset();
 }
 
-void UMeshWidgetComponent::RegisterWindow()
+void UMeshWidgetComponent::Freeze()
 {
-	if ( SlateWindow.IsValid() )
+	if ( bFrozen )
 	{
-		if ( FSlateApplication::IsInitialized() )
-		{
-			FSlateApplication::Get().RegisterVirtualWindow(SlateWindow.ToSharedRef());
-		}
+		return;
+	}
+
+	// Freezing right away takes over from a freeze waiting for its draw
+	bFreezePending = false;
+
+	// The texture is all that's left afterwards, so make sure it shows the current state
+	DrawWidgetToRenderTarget(0.0f);
+
+	if ( RenderTarget == nullptr )
+	{
+		return;
 	}
+
+	CompleteFreeze();
 }
 
-void UMeshWidgetComponent::UnregisterWindow()
+void UMeshWidgetComponent::RequestFreeze()
 {
-	if ( SlateWindow.IsValid() )
+	if ( bFrozen || bFreezePending )
 	{
-		if ( FSlateApplication::IsInitialized() )
-		{
-			FSlateApplication::Get().UnregisterVirtualWindow(SlateWindow.ToSharedRef());
-		}
+		return;
+	}
 
-		SlateWindow.Reset();
+	// Without a render target there is nothing to draw, the widget is drawn again from its user widget and
+	// frozen once the render target is restored
+	if ( bRenderTargetEvicted )
+	{
+		CompleteFreeze();
+		return;
+	}
+
+	UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>();
+	if ( Subsystem == nullptr || !SlateWindow.IsValid() || DrawSize.X == 0 || DrawSize.Y == 0 )
+	{
+		Freeze();
+		return;
 	}
+
+	bFreezePending = true;
+	RequestRedraw();
+	Subsystem->RequestRedrawSlot(this);
 }
 
-void UMeshWidgetComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+void UMeshWidgetComponent::CompleteFreeze()
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	// The live widget limit only takes the Slate side away, the user widget keeps its state for when it thaws
+	if ( bFrozenByLiveWidgetLimit )
+	{
+		ReleaseSlateResources();
+	}
+	else
+	{
+		ReleaseWidgetResources();
+	}
 
-    UpdateWidget();
+	bFreezePending = false;
+	bFrozen = true;
+}
 
-    if (Widget == nullptr && !SlateWidget.IsValid())
-    {
-        return;
-    }
+void UMeshWidgetComponent::Thaw()
+{
+	if ( !bFrozen )
+	{
+		// Thawed before the last draw came
+		bFreezePending = false;
+		return;
+	}
 
-    if (ShouldDrawWidget())
-    {
-        DrawWidgetToRenderTarget(DeltaTime);
-    }
+	bFrozen = false;
+
+	RecreateWidgetResources();
 }
 
-bool UMeshWidgetComponent::ShouldDrawWidget() const
+void UMeshWidgetComponent::ReleaseRenderTarget()
 {
-	const float RenderTimeThreshold = .5f;
-	if ( IsVisible() )
+	ReleaseRetiredRenderTarget();
+
+	if ( RenderTarget == nullptr )
+	{
+		return;
+	}
+
+	if ( UMeshWidgetSubsystem* Subsystem = GetWorld() ? GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() : nullptr )
 	{
-		// If we don't tick when off-screen, don't bother ticking if it hasn't been rendered recently
-		if ( TickWhenOffscreen || GetWorld()->TimeSince(GetLastRenderTime()) <= RenderTimeThreshold )
+		if ( bDrawingToSharedAtlas )
 		{
-			if ( GetWorld()->TimeSince(LastWidgetRenderTime) >= RedrawTime )
-			{
-				return bManuallyRedraw ? bRedrawRequested : true;
-			}
+			Subsystem->ReleaseAtlasRegion(RenderTarget, RenderTargetAllocation);
+		}
+		else
+		{
+			Subsystem->GetRenderTargetPool()->Release(RenderTarget);
 		}
 	}
 
-	return false;
+	RenderTarget = nullptr;
+	RenderTargetRegion = FIntRect();
+	RenderTargetAllocation = FIntRect();
+	bDrawingToSharedAtlas = false;
+	bFullRepaintNeeded = true;
+
+	NotifyMirrors();
 }
 
-void UMeshWidgetComponent::DrawWidgetToRenderTarget(float DeltaTime)
+void UMeshWidgetComponent::ReleaseRetiredRenderTarget()
 {
-	if ( GUsingNullRHI )
+	if ( RetiredRenderTarget == nullptr )
 	{
 		return;
 	}
 
-	if ( !SlateWindow.IsValid() )
+	// Retired render targets are never atlas pages, a widget moving into the atlas releases everything first
+	if ( UMeshWidgetSubsystem* Subsystem = GetWorld() ? GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() : nullptr )
 	{
-		return;
+		Subsystem->GetRenderTargetPool()->Release(RetiredRenderTarget);
 	}
 
-	if ( DrawSize.X == 0 || DrawSize.Y == 0 )
+	RetiredRenderTarget = nullptr;
+	bRenderTargetSwapFenceBegun = false;
+}
+
+void UMeshWidgetComponent::UpdateRenderTargetSwap()
+{
+	// Polling the fence doesn't wait, the retired render target is simply shown until the render thread is there
+	if ( RetiredRenderTarget == nullptr || !bRenderTargetSwapFenceBegun || !RenderTargetSwapFence.IsFenceComplete() )
 	{
 		return;
 	}
 
-	CurrentDrawSize = DrawSize;
+	ReleaseRetiredRenderTarget();
 
-	const float DrawScale = 1.0f;
+	SetMaterialTextureParameter(MeshWidgetMaterialParameters::SlateUI, RenderTarget);
+	SetMaterialVectorParameter(MeshWidgetMaterialParameters::AtlasUVScaleOffset, GetRenderTargetRegionScaleOffset());
+	NotifyMirrors();
+}
 
-	if ( bDrawAtDesiredSize )
+UTextureRenderTarget2D* UMeshWidgetComponent::AcquireRenderTarget(FIntPoint Size, const FLinearColor& ClearColor)
+{
+	if ( UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() )
 	{
-		SlateWindow->SlatePrepass(DrawScale);
+		return Subsystem->GetRenderTargetPool()->Acquire(FMeshWidgetRenderTargetDesc(Size, GetRenderTargetPixelFormat(), bForceLinearGamma, ClearColor, UsesMips(), MipFilter));
+	}
 
-		FVector2D DesiredSize = SlateWindow->GetDesiredSize();
-		DesiredSize.X = FMath::RoundToInt(DesiredSize.X);
-		DesiredSize.Y = FMath::RoundToInt(DesiredSize.Y);
-		CurrentDrawSize = DesiredSize.IntPoint();
+	UTextureRenderTarget2D* NewRenderTarget = NewObject<UTextureRenderTarget2D>(this);
+	NewRenderTarget->ClearColor = ClearColor;
+	NewRenderTarget->bAutoGenerateMips = UsesMips();
+	NewRenderTarget->MipsSamplerFilter = MipFilter;
+	NewRenderTarget->InitCustomFormat(Size.X, Size.Y, GetRenderTargetPixelFormat(), bForceLinearGamma);
+	return NewRenderTarget;
+}
 
-		WidgetRenderer->SetIsPrepassNeeded(false);
+void UMeshWidgetComponent::OnSharedAtlasResized()
+{
+	SetMaterialVectorParameter(MeshWidgetMaterialParameters::AtlasUVScaleOffset, GetRenderTargetRegionScaleOffset());
+	NotifyMirrors();
+
+	// Resizing the page cleared our region.  A frozen widget had nothing else left, so it is drawn once more
+	bFullRepaintNeeded = true;
+	if ( bFrozen )
+	{
+		RedrawFrozenWidget();
 	}
 	else
 	{
-		WidgetRenderer->SetIsPrepassNeeded(true);
+		RequestRedraw();
 	}
+}
 
-	if ( CurrentDrawSize != DrawSize )
+bool UMeshWidgetComponent::CountsAsLiveWidget() const
+{
+	if ( MirrorSource || bWidgetDormant || !IsRegistered() )
 	{
-		DrawSize = CurrentDrawSize;
-		RecreatePhysicsState();
+		return false;
 	}
 
-	UpdateRenderTarget(CurrentDrawSize);
-
-	bRedrawRequested = false;
-
-	WidgetRenderer->DrawWindow(
-		GetRenderTarget(),
-		HitTestGrid.ToSharedRef().Get(),
-		SlateWindow.ToSharedRef(),
-		DrawScale,
-		CurrentDrawSize,
-		DeltaTime);
+	if ( bFrozen )
+	{
+		return bFrozenByLiveWidgetLimit;
+	}
 
-	LastWidgetRenderTime = GetWorld()->TimeSeconds;
+	return Widget != nullptr || SlateWidget.IsValid();
 }
 
-class FMeshWidgetComponentInstanceData : public FSceneComponentInstanceData
+void UMeshWidgetComponent::SetFrozenByLiveWidgetLimit(bool bInFrozen)
 {
-public:
-	FMeshWidgetComponentInstanceData( const UMeshWidgetComponent* SourceComponent )
-		: FSceneComponentInstanceData(SourceComponent)
-		, WidgetClass ( SourceComponent->GetWidgetClass() )
-		, RenderTarget( SourceComponent->GetRenderTarget() )
-	{}
-
-	virtual void ApplyToComponent(UActorComponent* Component, const ECacheApplyPhase CacheApplyPhase) override
+	if ( bInFrozen == bFrozenByLiveWidgetLimit )
 	{
-		FSceneComponentInstanceData::ApplyToComponent(Component, CacheApplyPhase);
-		CastChecked<UMeshWidgetComponent>(Component)->ApplyComponentInstanceData(this);
+		return;
 	}
 
-	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+	if ( bInFrozen )
 	{
-		FSceneComponentInstanceData::AddReferencedObjects(Collector);
-
-		UClass* WidgetUClass = *WidgetClass;
-		Collector.AddReferencedObject(WidgetUClass);
-		Collector.AddReferencedObject(RenderTarget);
+		bFrozenByLiveWidgetLimit = true;
+		RequestFreeze();
+		bFrozenByLiveWidgetLimit = bFrozen || bFreezePending;
 	}
+	else
+	{
+		bFrozenByLiveWidgetLimit = false;
+		Thaw();
+	}
+}
 
-public:
-	TSubclassOf<UUserWidget> WidgetClass;
-	UTextureRenderTarget2D* RenderTarget;
-};
-
-TStructOnScope < FActorComponentInstanceData > UMeshWidgetComponent::GetComponentInstanceData() const
+bool UMeshWidgetComponent::CanEvictRenderTarget() const
 {
-	return MakeStructOnScope< FActorComponentInstanceData >(this);
+	// Atlas pages never shrink, so giving up a region frees nothing.  A widget frozen with Freeze has nothing
+	// left to draw a new texture from
+	const bool bFrozenByCaller = bFrozen && !bFrozenByClassLOD && !bFrozenByLiveWidgetLimit;
+	return RenderTarget && !bDrawingToSharedAtlas && !bRenderTargetEvicted && !bFrozenByCaller && !bFreezePending && MirrorSource == nullptr && !TickWhenOffscreen && IsRegistered();
 }
 
-void UMeshWidgetComponent::ApplyComponentInstanceData(FMeshWidgetComponentInstanceData* WidgetInstanceData)
+void UMeshWidgetComponent::EvictRenderTarget()
 {
-	check(WidgetInstanceData);
+	if ( !CanEvictRenderTarget() )
+	{
+		return;
+	}
 
-	// Note: ApplyComponentInstanceData is called while the component is registered so the rendering thread is already using this component
-	// That means all component state that is modified here must be mirrored on the scene proxy, which will be recreated to receive the changes later due to MarkRenderStateDirty.
+	ReleaseRenderTarget();
+	SetMaterialTextureParameter(MeshWidgetMaterialParameters::SlateUI, nullptr);
 
-	if (GetWidgetClass() != WidgetClass)
+	bRenderTargetEvicted = true;
+}
+
+void UMeshWidgetComponent::RestoreRenderTarget()
+{
+	if ( !bRenderTargetEvicted )
 	{
 		return;
 	}
 
-	RenderTarget = WidgetInstanceData->RenderTarget;
-	if( MaterialInstance && RenderTarget )
+	bRenderTargetEvicted = false;
+
+	if ( !bFrozen )
 	{
-		MaterialInstance->SetTextureParameterValue("SlateUI", RenderTarget);
+		RequestRedraw();
+		return;
 	}
 
-	MarkRenderStateDirty();
+	RedrawFrozenWidget();
 }
 
-#if WITH_EDITORONLY_DATA
-void UMeshWidgetComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+void UMeshWidgetComponent::RedrawFrozenWidget()
 {
-	UProperty* Property = PropertyChangedEvent.MemberProperty;
+	// A class LOD impostor has nothing to be drawn from without the class of the widget it was frozen from
+	if ( bFrozenByClassLOD && LODStateWidgetClass == nullptr )
+	{
+		WidgetClassLOD = 0;
+		bFrozenByClassLOD = false;
+		Thaw();
+		return;
+	}
 
-	if( Property && PropertyChangedEvent.ChangeType != EPropertyChangeType::Interactive )
+	// The widget is drawn again from a new widget of the class it was frozen from, with the state it saved, at
+	// the same class LOD, and freezes again after that draw
+	if ( bFrozenByClassLOD && GetWorld() )
 	{
-		static FName DrawSizeName("DrawSize");
-		static FName PivotName("Pivot");
-		static FName WidgetClassName("WidgetClass");
-		static FName IsOpaqueName("bIsOpaque");
-		static FName IsTwoSidedName("bIsTwoSided");
-		static FName BackgroundColorName("BackgroundColor");
-		static FName TintColorAndOpacityName("TintColorAndOpacity");
-		static FName OpacityFromTextureName("OpacityFromTexture");
-		static FName ParabolaDistortionName(TEXT("ParabolaDistortion"));
-		static FName BlendModeName( TEXT( "BlendMode" ) );
+		Widget = CreateWidget<UUserWidget>(GetWorld(), LODStateWidgetClass);
+		RestoreLODStateFrom(LODState);
+	}
 
-		auto PropertyName = Property->GetFName();
+	bFrozen = false;
+	RecreateWidgetResources();
+	RequestFreeze();
+}
 
-		if( PropertyName == WidgetClassName )
+bool UMeshWidgetComponent::IsInOrNearAnyView() const
+{
+	UMeshWidgetSubsystem* Subsystem = GetWorld() ? GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() : nullptr;
+	if ( Subsystem == nullptr )
+	{
+		return true;
+	}
+
+	// Frozen widgets don't tick, so ask the subsystem rather than trusting ViewVisibility
+	if ( IsVisible() && Subsystem->GetViewVisibility(this) != EMeshWidgetViewVisibility::Hidden )
+	{
+		return true;
+	}
+
+	for ( const UMeshWidgetComponent* Mirror : Mirrors )
+	{
+		if ( Mirror && Mirror->IsVisible() && Subsystem->GetViewVisibility(Mirror) != EMeshWidgetViewVisibility::Hidden )
 		{
-			//in editor rendering is not working so this does nothing
-			//Widget = nullptr;
-			//RenderTarget->UpdateResourceImmediate(true); //clear the old widget render from texture, should probably set base material if set to none
-			//UpdateWidget();
-			MarkRenderStateDirty();
+			return true;
 		}
-		else if ( PropertyName == DrawSizeName || PropertyName == PivotName )
+	}
+
+	return false;
+}
+
+float UMeshWidgetComponent::GetLastSeenTime() const
+{
+	float LastSeenTime = GetLastRenderTimeOnScreen();
+	for ( const UMeshWidgetComponent* Mirror : Mirrors )
+	{
+		if ( Mirror )
 		{
-			MarkRenderStateDirty();
-			RecreatePhysicsState();
+			LastSeenTime = FMath::Max(LastSeenTime, Mirror->GetLastRenderTimeOnScreen());
 		}
-		else if ( PropertyName == IsOpaqueName || PropertyName == IsTwoSidedName || PropertyName == BlendModeName )
+	}
+
+	return LastSeenTime;
+}
+
+FMeshWidgetMemoryUsage UMeshWidgetComponent::GetMemoryUsage() const
+{
+	FMeshWidgetMemoryUsage Usage;
+
+	if ( RenderTarget )
+	{
+		Usage.RenderTargetBytes = RenderTarget->CalcTextureMemorySizeEnum(TMC_AllMips);
+
+		// Other widgets share the rest of the page
+		if ( bDrawingToSharedAtlas && RenderTarget->SizeX > 0 && RenderTarget->SizeY > 0 )
 		{
-			MarkRenderStateDirty();
+			Usage.RenderTargetBytes = Usage.RenderTargetBytes * RenderTargetAllocation.Area() / ( (int64)RenderTarget->SizeX * RenderTarget->SizeY );
 		}
-		else if( PropertyName == BackgroundColorName || PropertyName == ParabolaDistortionName )
+	}
+
+	if ( RetiredRenderTarget )
+	{
+		Usage.RenderTargetBytes += RetiredRenderTarget->CalcTextureMemorySizeEnum(TMC_AllMips);
+	}
+
+	if ( Widget )
+	{
+		Usage.UserWidgetBytes = Widget->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		if ( Widget->WidgetTree )
 		{
-			MarkRenderStateDirty();
+			Widget->WidgetTree->ForEachWidget([&Usage](UWidget* TreeWidget)
+			{
+				Usage.UserWidgetBytes += TreeWidget->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+			});
 		}
-		else if( PropertyName == TintColorAndOpacityName || PropertyName == OpacityFromTextureName )
+	}
+
+	// Slate doesn't report the size of its allocations, count the objects we own
+	if ( SlateWindow.IsValid() )
+	{
+		Usage.SlateBytes += sizeof(SVirtualWindow);
+	}
+	if ( HitTestGrid.IsValid() )
+	{
+		Usage.SlateBytes += sizeof(FHittestGrid);
+	}
+	if ( PartialHitTestGrid.IsValid() )
+	{
+		Usage.SlateBytes += sizeof(FHittestGrid);
+	}
+	if ( WidgetRenderer.IsValid() )
+	{
+		Usage.SlateBytes += sizeof(FWidgetRenderer);
+	}
+
+	if ( MaterialInstance )
+	{
+		Usage.MaterialBytes = MaterialInstance->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	}
+
+	return Usage;
+}
+
+void UMeshWidgetComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	// The render targets belong to the pool or the subsystem, but they are only alive because of us
+	const FMeshWidgetMemoryUsage Usage = GetMemoryUsage();
+	CumulativeResourceSize.AddDedicatedVideoMemoryBytes(Usage.RenderTargetBytes);
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Usage.SlateBytes);
+
+	if ( CumulativeResourceSize.GetResourceSizeMode() == EResourceSizeMode::EstimatedTotal )
+	{
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Usage.UserWidgetBytes + Usage.MaterialBytes);
+	}
+}
+
+void UMeshWidgetComponent::RegisterWindow()
+{
+	if ( SlateWindow.IsValid() )
+	{
+		if ( FSlateApplication::IsInitialized() )
+		{
+			FSlateApplication::Get().RegisterVirtualWindow(SlateWindow.ToSharedRef());
+		}
+	}
+}
+
+void UMeshWidgetComponent::UnregisterWindow()
+{
+	if ( SlateWindow.IsValid() )
+	{
+		if ( FSlateApplication::IsInitialized() )
+		{
+			FSlateApplication::Get().UnregisterVirtualWindow(SlateWindow.ToSharedRef());
+		}
+
+		SlateWindow.Reset();
+	}
+}
+
+void UMeshWidgetComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// The source draws for us, it only needs to know whether we are seen
+	if ( MirrorSource )
+	{
+		UpdateViewVisibility();
+		return;
+	}
+
+	UpdateRenderTargetSwap();
+
+	if ( bWidgetDormant )
+	{
+		UpdateViewVisibility();
+		if ( !IsWidgetNeeded() )
+		{
+			return;
+		}
+
+		WakeWidget();
+	}
+
+	// Switching may freeze or thaw the widget
+	UpdateWidgetClassLOD();
+
+	if ( bFrozen )
+	{
+		return;
+	}
+
+    UpdateWidget();
+
+    if (Widget == nullptr && !SlateWidget.IsValid())
+    {
+        return;
+    }
+
+	// A sharper or blurrier version has to be drawn even if the content didn't change
+	if ( UpdateResolutionLOD() )
+	{
+		RequestRedraw();
+	}
+
+	UpdateViewVisibility();
+
+	if ( IsWidgetNeeded() )
+	{
+		LastNeededTime = GetWorld()->TimeSeconds;
+	}
+	else if ( ReleaseWhenUnseenTime > 0.0f && GetWorld()->TimeSince(LastNeededTime) >= ReleaseWhenUnseenTime )
+	{
+		ReleaseUnneededWidget();
+		return;
+	}
+
+	if ( bAdaptiveRedrawRate )
+	{
+		UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>();
+		RedrawSignificance = Subsystem ? Subsystem->GetSignificance(this) : 1.0f;
+
+		// Redraw as often as the most significant mirror needs
+		for ( const UMeshWidgetComponent* Mirror : Mirrors )
+		{
+			if ( Subsystem && Mirror )
+			{
+				RedrawSignificance = FMath::Max(RedrawSignificance, Subsystem->GetSignificance(Mirror));
+			}
+		}
+	}
+
+	// A freeze waits for its last draw whatever the redraw rate
+    if (bFreezePending || ShouldDrawWidget())
+    {
+		// Let the world's scheduler decide when we fit in the frame budget
+		if ( UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() )
+		{
+			Subsystem->RequestRedrawSlot(this);
+		}
+		else
+		{
+			DrawWidgetToRenderTarget(DeltaTime);
+		}
+    }
+}
+
+bool UMeshWidgetComponent::ShouldDrawWidget() const
+{
+	// The subsystem restores the render target once the widget is seen again
+	if ( bRenderTargetEvicted )
+	{
+		return false;
+	}
+
+	// A hidden source still draws for the mirrors that are seen
+	if ( IsVisible() || IsAnyMirrorInOrNearView() )
+	{
+		// If we don't tick when off-screen, don't bother ticking if nobody can see it
+		if ( TickWhenOffscreen || IsInOrNearView() || IsAnyMirrorInOrNearView() )
+		{
+			if ( GetWorld()->TimeSince(LastWidgetRenderTime) >= GetEffectiveRedrawTime() )
+			{
+				if ( bManuallyRedraw )
+				{
+					return bRedrawRequested;
+				}
+
+				return bRedrawOnlyWhenChanged ? bRedrawRequested || HasWidgetChanged() : true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void UMeshWidgetComponent::UpdateViewVisibility()
+{
+	const bool bWasInView = ViewVisibility == EMeshWidgetViewVisibility::InView;
+
+	UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>();
+	ViewVisibility = Subsystem ? Subsystem->GetViewVisibility(this) : EMeshWidgetViewVisibility::Unknown;
+
+	bOccluded = false;
+
+	// Occlusion results are a frame old, they only mean something if we were in view for that frame too
+	if ( bSkipRedrawWhenOccluded && bWasInView && ViewVisibility == EMeshWidgetViewVisibility::InView )
+	{
+		const UWorld* World = GetWorld();
+		bOccluded = GetLastRenderTimeOnScreen() < World->GetTimeSeconds() - World->GetDeltaSeconds() * 1.5f;
+	}
+}
+
+bool UMeshWidgetComponent::IsInOrNearView() const
+{
+	switch ( ViewVisibility )
+	{
+	case EMeshWidgetViewVisibility::InView:
+		return !bOccluded;
+	case EMeshWidgetViewVisibility::NearView:
+		// Draw ahead of time so the widget doesn't show stale content when it comes into view
+		return true;
+	case EMeshWidgetViewVisibility::Hidden:
+		return false;
+	default:
+	{
+		// Without player views (editor viewports, no local players) fall back to the last render time
+		const float RenderTimeThreshold = .5f;
+		return GetWorld()->TimeSince(GetLastRenderTime()) <= RenderTimeThreshold;
+	}
+	}
+}
+
+bool UMeshWidgetComponent::IsWidgetNeeded() const
+{
+	if ( IsHovered() || IsAnyMirrorInOrNearView() )
+	{
+		return true;
+	}
+
+	return IsVisible() && ( TickWhenOffscreen || IsInOrNearView() );
+}
+
+void UMeshWidgetComponent::WakeWidget()
+{
+	if ( !bWidgetDormant )
+	{
+		return;
+	}
+
+	bWidgetDormant = false;
+	LastNeededTime = GetWorld()->TimeSeconds;
+
+	RecreateWidgetResources();
+}
+
+void UMeshWidgetComponent::ReleaseUnneededWidget()
+{
+	if ( bWidgetDormant || bFrozen || bFreezePending || MirrorSource )
+	{
+		return;
+	}
+
+	ReleaseWidgetResources();
+	ReleaseRenderTarget();
+	SetMaterialTextureParameter(MeshWidgetMaterialParameters::SlateUI, nullptr);
+
+	// Waking draws into a new render target anyway
+	bRenderTargetEvicted = false;
+	bWidgetDormant = true;
+}
+
+void UMeshWidgetComponent::ReleaseWidgetResources()
+{
+	// A user widget created from the class can be created again later, one set with SetWidget can't
+	if ( WidgetClass )
+	{
+		Widget = nullptr;
+	}
+
+	ReleaseSlateResources();
+}
+
+void UMeshWidgetComponent::RecreateWidgetResources()
+{
+	if ( !WidgetRenderer.IsValid() && !GUsingNullRHI )
+	{
+		WidgetRenderer = MakeShareable(new FWidgetRenderer());
+	}
+
+	InitWidget();
+	UpdateWidget();
+	RequestRedraw();
+}
+
+void UMeshWidgetComponent::CopyLODStateFrom(UUserWidget* PreviousWidget)
+{
+	if ( Widget && PreviousWidget && Widget != PreviousWidget && Widget->GetClass()->ImplementsInterface(UMeshWidgetLODInterface::StaticClass()) )
+	{
+		IMeshWidgetLODInterface::Execute_CopyLODState(Widget, PreviousWidget);
+	}
+}
+
+UObject* UMeshWidgetComponent::SaveLODStateOf(UUserWidget* InWidget)
+{
+	if ( InWidget && InWidget->GetClass()->ImplementsInterface(UMeshWidgetLODInterface::StaticClass()) )
+	{
+		return IMeshWidgetLODInterface::Execute_SaveLODState(InWidget);
+	}
+
+	return nullptr;
+}
+
+void UMeshWidgetComponent::RestoreLODStateFrom(UObject* SavedState)
+{
+	if ( Widget && SavedState && Widget->GetClass()->ImplementsInterface(UMeshWidgetLODInterface::StaticClass()) )
+	{
+		IMeshWidgetLODInterface::Execute_RestoreLODState(Widget, SavedState);
+	}
+}
+
+bool UMeshWidgetComponent::IsAnyMirrorInOrNearView() const
+{
+	for ( const UMeshWidgetComponent* Mirror : Mirrors )
+	{
+		if ( Mirror && Mirror->IsVisible() && ( Mirror->TickWhenOffscreen || Mirror->IsInOrNearView() ) )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UMeshWidgetComponent::SetMirrorSource(UMeshWidgetComponent* NewSource)
+{
+	// Follow chains to the widget that actually draws, a mirror never draws for anyone
+	while ( NewSource && NewSource->MirrorSource )
+	{
+		NewSource = NewSource->MirrorSource;
+	}
+
+	if ( NewSource == this || NewSource == MirrorSource )
+	{
+		return;
+	}
+
+	if ( MirrorSource )
+	{
+		MirrorSource->Mirrors.RemoveSingleSwap(this);
+	}
+
+	MirrorSource = NewSource;
+
+	if ( MirrorSource )
+	{
+		MirrorSource->Mirrors.AddUnique(this);
+
+		// Our own widget, window and render target are not needed anymore
+		ReleaseResources();
+
+		// Whoever mirrored us now mirrors our source
+		const TArray<UMeshWidgetComponent*> OwnMirrors = Mirrors;
+		for ( UMeshWidgetComponent* Mirror : OwnMirrors )
+		{
+			if ( Mirror )
+			{
+				Mirror->SetMirrorSource(MirrorSource);
+			}
+		}
+
+		MirrorSource->RequestRedraw();
+	}
+	else
+	{
+		if ( !WidgetRenderer.IsValid() && !GUsingNullRHI )
+		{
+			WidgetRenderer = MakeShareable(new FWidgetRenderer());
+		}
+
+		InitWidget();
+		UpdateWidget();
+		RequestRedraw();
+	}
+
+	// The base material may change with the render target we show
+	MarkRenderStateDirty();
+}
+
+void UMeshWidgetComponent::OnMirrorSourceUpdated()
+{
+	if ( MaterialInstanceBase != GetBaseMaterial() )
+	{
+		MarkRenderStateDirty();
+	}
+	else
+	{
+		UpdateMaterialInstanceParameters();
+	}
+}
+
+void UMeshWidgetComponent::NotifyMirrors()
+{
+	for ( UMeshWidgetComponent* Mirror : Mirrors )
+	{
+		if ( Mirror )
+		{
+			Mirror->OnMirrorSourceUpdated();
+		}
+	}
+}
+
+void UMeshWidgetComponent::UnlinkMirrors()
+{
+	if ( MirrorSource )
+	{
+		MirrorSource->Mirrors.RemoveSingleSwap(this);
+		MirrorSource = nullptr;
+	}
+
+	const UWorld* World = GetWorld();
+	const bool bWorldTearingDown = World == nullptr || World->bIsTearingDown;
+
+	// Mirrors of a widget that goes away draw their own widget again, unless they are going away too
+	const TArray<UMeshWidgetComponent*> OldMirrors = MoveTemp(Mirrors);
+	Mirrors.Reset();
+	for ( UMeshWidgetComponent* Mirror : OldMirrors )
+	{
+		if ( Mirror == nullptr )
+		{
+			continue;
+		}
+
+		if ( !bWorldTearingDown && Mirror->IsRegistered() && !Mirror->IsBeingDestroyed() )
+		{
+			Mirror->SetMirrorSource(nullptr);
+		}
+		else
+		{
+			Mirror->MirrorSource = nullptr;
+		}
+	}
+}
+
+float UMeshWidgetComponent::GetEffectiveRedrawTime() const
+{
+	// Scalability may cap the redraw rate of every widget
+	const float MaxScalabilityRate = MeshWidgetScalability::GetMaxRedrawRate();
+	const float MinRedrawTime = MaxScalabilityRate > 0.0f ? 1.0f / MaxScalabilityRate : 0.0f;
+
+	if ( !bAdaptiveRedrawRate )
+	{
+		return FMath::Max(RedrawTime, MinRedrawTime);
+	}
+
+	const float MinRate = FMath::Max(MinRedrawRate, 0.1f);
+	const float MaxRate = FMath::Max(MaxRedrawRate, MinRate);
+
+	return FMath::Max(1.0f / FMath::Lerp(MinRate, MaxRate, RedrawSignificance), MinRedrawTime);
+}
+
+bool UMeshWidgetComponent::DrawWidgetToRenderTarget(float DeltaTime, bool bAllowDeferredUpdate)
+{
+	if ( GUsingNullRHI || bRenderTargetEvicted )
+	{
+		return false;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetDrawWidget);
+	MESHWIDGET_SCOPED_NAMED_EVENT("MeshWidget Draw", this);
+
+	if ( !SlateWindow.IsValid() )
+	{
+		return false;
+	}
+
+	if ( DrawSize.X == 0 || DrawSize.Y == 0 )
+	{
+		return false;
+	}
+
+	CurrentDrawSize = DrawSize;
+
+	const float DrawScale = FMath::Pow(0.5f, ResolutionLOD) * MeshWidgetScalability::GetResolutionScale();
+
+	if ( bDrawAtDesiredSize )
+	{
+		// Measuring walks and lays out the whole tree, skip it while the layout can't have changed
+		if ( NeedsDesiredSizePrepass(DrawScale) )
+		{
+			{
+				SCOPE_CYCLE_COUNTER(STAT_MeshWidgetSlatePrepass);
+				SlateWindow->SlatePrepass(DrawScale);
+			}
+
+			// The window is laid out at the desired size itself, only the render target allocation is rounded up
+			const FVector2D DesiredSize = SlateWindow->GetDesiredSize();
+			CurrentDrawSize = FIntPoint(FMath::Max(1, FMath::RoundToInt(DesiredSize.X)), FMath::Max(1, FMath::RoundToInt(DesiredSize.Y)));
+
+			// The signature includes the draw size, so take it with the new one
+			DrawSize = CurrentDrawSize;
+			bHasDesiredSizePrepass = true;
+			DesiredSizePrepassSignature = ComputeWidgetSignature();
+			DesiredSizePrepassScale = DrawScale;
+			DesiredSizePrepassTime = GetWorld()->TimeSeconds;
+		}
+
+		WidgetRenderer->SetIsPrepassNeeded(false);
+	}
+	else if ( bUseDirtyRegions )
+	{
+		// Diffing the tree needs the desired sizes of this frame
+		SCOPE_CYCLE_COUNTER(STAT_MeshWidgetSlatePrepass);
+		SlateWindow->SlatePrepass(DrawScale);
+		WidgetRenderer->SetIsPrepassNeeded(false);
+	}
+	else
+	{
+		WidgetRenderer->SetIsPrepassNeeded(true);
+	}
+
+	// The collision comes from the static mesh, so unlike a widget component's quad it doesn't depend on the size
+	DrawSize = CurrentDrawSize;
+
+	const FIntPoint UsedRenderTargetSize(
+		FMath::Max(1, FMath::CeilToInt(CurrentDrawSize.X * DrawScale)),
+		FMath::Max(1, FMath::CeilToInt(CurrentDrawSize.Y * DrawScale)));
+
+	// Desired sizes change by a pixel at a time, rounding up the allocation keeps them from swapping the render
+	// target.  A material sampling the whole texture would show the unused part, so it gets the exact size
+	const FIntPoint RenderTargetSize = bDrawAtDesiredSize && CanSampleRenderTargetRegion() ? SnapRenderTargetSize(UsedRenderTargetSize) : UsedRenderTargetSize;
+
+	const UTextureRenderTarget2D* PreviousRenderTarget = RenderTarget;
+	const FIntRect PreviousRenderTargetRegion = RenderTargetRegion;
+
+	UpdateRenderTarget(RenderTargetSize, UsedRenderTargetSize);
+
+	// Nothing drawn before is where this draw would put it
+	if ( RenderTarget != PreviousRenderTarget || RenderTargetRegion != PreviousRenderTargetRegion || DrawScale != CurrentDrawScale )
+	{
+		bFullRepaintNeeded = true;
+	}
+
+	bRedrawRequested = false;
+	CurrentDrawScale = DrawScale;
+
+	FIntRect PaintRegion;
+	const bool bPartialRepaint = ComputeDirtyRegion(PaintRegion);
+
+	if ( DirtyRegionHost.IsValid() )
+	{
+		DirtyRegionHost->SetPaintRegion(bPartialRepaint ? TOptional<FSlateRect>(FSlateRect(PaintRegion.Min.X, PaintRegion.Min.Y, PaintRegion.Max.X, PaintRegion.Max.Y)) : TOptional<FSlateRect>());
+	}
+
+	// Other widgets share the atlas render target, and a partial repaint keeps what's outside the dirty region,
+	// so only the region being painted may be cleared
+	WidgetRenderer->SetShouldClearTarget(!bDrawingToSharedAtlas && !bPartialRepaint);
+	if ( bDrawingToSharedAtlas || bPartialRepaint )
+	{
+		MeshWidgetRendering::ClearRenderTargetRegion(RenderTarget, PaintRegion, GetRenderTargetClearColor());
+	}
+
+	if ( bPartialRepaint && !PartialHitTestGrid.IsValid() )
+	{
+		PartialHitTestGrid = MakeShareable(new FHittestGrid);
+	}
+
+	const FGeometry WindowGeometry = FGeometry::MakeRoot(FVector2D(CurrentDrawSize), FSlateLayoutTransform(DrawScale, FVector2D(RenderTargetRegion.Min)));
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_MeshWidgetDrawWindow);
+		WidgetRenderer->DrawWindow(
+			GetRenderTarget(),
+			bPartialRepaint ? PartialHitTestGrid.ToSharedRef().Get() : HitTestGrid.ToSharedRef().Get(),
+			SlateWindow.ToSharedRef(),
+			WindowGeometry,
+			DeltaTime,
+			bAllowDeferredUpdate && CanDeferRenderTargetUpdate());
+	}
+
+	INC_DWORD_STAT(STAT_MeshWidgetNumRedraws);
+	if ( bPartialRepaint )
+	{
+		INC_DWORD_STAT(STAT_MeshWidgetNumPartialRedraws);
+	}
+
+	// The draw into a new render target is enqueued, once the render thread passes the fence it can be shown
+	if ( RetiredRenderTarget && !bRenderTargetSwapFenceBegun )
+	{
+		RenderTargetSwapFence.BeginFence();
+		bRenderTargetSwapFenceBegun = true;
+	}
+
+	LastWidgetRenderTime = GetWorld()->TimeSeconds;
+	NumRedraws++;
+	LastRedrawCoverage = bPartialRepaint ? (float)PaintRegion.Area() / FMath::Max(1, RenderTargetRegion.Area()) : 1.0f;
+
+	// Painting laid out the tree, so its geometry is the base the next draws are diffed against
+	if ( !bPartialRepaint && DirtyRegionTracker.IsValid() )
+	{
+		DirtyRegionTracker->Record(*SlateWindow);
+		bFullRepaintNeeded = false;
+		LastFullRepaintTime = LastWidgetRenderTime;
+	}
+
+	const uint32 WidgetSignature = bRedrawOnlyWhenChanged || MipGeneration == EMeshWidgetMipGeneration::OnChange ? ComputeWidgetSignature() : 0;
+
+	if ( bRedrawOnlyWhenChanged )
+	{
+		LastDrawnWidgetSignature = WidgetSignature;
+	}
+
+	if ( ShouldGenerateMips(WidgetSignature) )
+	{
+		MeshWidgetRendering::GenerateMips(RenderTarget, MipFilter);
+		LastMipsWidgetSignature = WidgetSignature;
+		bMipsDirty = false;
+	}
+
+	if ( bFreezePending )
+	{
+		CompleteFreeze();
+	}
+
+	return true;
+}
+
+bool UMeshWidgetComponent::ComputeDirtyRegion(FIntRect& OutPaintRegion)
+{
+	OutPaintRegion = RenderTargetRegion;
+
+	if ( !bUseDirtyRegions || !DirtyRegionTracker.IsValid() || bFullRepaintNeeded )
+	{
+		return false;
+	}
+
+	if ( DirtyRegionFullRepaintInterval > 0.0f && GetWorld()->TimeSince(LastFullRepaintTime) >= DirtyRegionFullRepaintInterval )
+	{
+		return false;
+	}
+
+	FBox2D DirtyBox;
+	if ( !DirtyRegionTracker->Update(*SlateWindow, DirtyBox) )
+	{
+		return false;
+	}
+
+	// Nothing changed, the draw still ticks the root of the user widget
+	if ( !DirtyBox.bIsValid )
+	{
+		OutPaintRegion = FIntRect(RenderTargetRegion.Min, RenderTargetRegion.Min);
+		return true;
+	}
+
+	// Anti-aliased edges and outlines bleed a little past the geometry
+	const int32 Padding = 2;
+	FIntRect DirtyRect(
+		FMath::FloorToInt(DirtyBox.Min.X) - Padding,
+		FMath::FloorToInt(DirtyBox.Min.Y) - Padding,
+		FMath::CeilToInt(DirtyBox.Max.X) + Padding,
+		FMath::CeilToInt(DirtyBox.Max.Y) + Padding);
+	DirtyRect.Clip(RenderTargetRegion);
+
+	if ( DirtyRect.Area() > DirtyRegionFullRepaintThreshold * RenderTargetRegion.Area() )
+	{
+		return false;
+	}
+
+	OutPaintRegion = DirtyRect;
+	return true;
+}
+
+namespace MeshWidgetDesiredSize
+{
+	/** Render targets for the desired size are rounded up to multiples of this */
+	const int32 SizeStep = 32;
+
+	/** The desired size is measured again at least this often, for layout changes the signature doesn't catch */
+	const float MaxPrepassAge = 1.0f;
+
+	static int32 SnapAxis(int32 Desired, int32 Current)
+	{
+		const int32 Snapped = FMath::Max(1, FMath::DivideAndRoundUp(Desired, SizeStep)) * SizeStep;
+
+		// Grow right away, shrink only once the desired size is two steps or more below the current size
+		if ( Current >= Snapped && Current - Desired < SizeStep * 2 )
+		{
+			return Current;
+		}
+
+		return Snapped;
+	}
+}
+
+bool UMeshWidgetComponent::NeedsDesiredSizePrepass(float LayoutScale) const
+{
+	if ( !bHasDesiredSizePrepass || LayoutScale != DesiredSizePrepassScale )
+	{
+		return true;
+	}
+
+	if ( Widget && Widget->IsAnyAnimationPlaying() )
+	{
+		return true;
+	}
+
+	if ( GetWorld()->TimeSince(DesiredSizePrepassTime) >= MeshWidgetDesiredSize::MaxPrepassAge )
+	{
+		return true;
+	}
+
+	return ComputeWidgetSignature() != DesiredSizePrepassSignature;
+}
+
+FIntPoint UMeshWidgetComponent::SnapRenderTargetSize(FIntPoint UsedRenderTargetSize) const
+{
+	const FIntPoint CurrentSize = RenderTarget ? RenderTargetAllocation.Size() : FIntPoint::ZeroValue;
+
+	return FIntPoint(
+		MeshWidgetDesiredSize::SnapAxis(UsedRenderTargetSize.X, CurrentSize.X),
+		MeshWidgetDesiredSize::SnapAxis(UsedRenderTargetSize.Y, CurrentSize.Y));
+}
+
+bool UMeshWidgetComponent::CanSampleRenderTargetRegion() const
+{
+	const auto SamplesRegion = [](const UMaterialInterface* Material)
+	{
+		FLinearColor ScaleOffset;
+		return Material && Material->GetVectorParameterValue(FMaterialParameterInfo(MeshWidgetMaterialParameters::AtlasUVScaleOffset), ScaleOffset);
+	};
+
+	if ( !SamplesRegion(GetBaseMaterial()) )
+	{
+		return false;
+	}
+
+	for ( const UMeshWidgetComponent* Mirror : Mirrors )
+	{
+		if ( Mirror && !SamplesRegion(Mirror->GetBaseMaterial()) )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool UMeshWidgetComponent::CanDeferRenderTargetUpdate() const
+{
+	// Mips are generated from the drawn contents right after the draw, and atlas pages can be resized (which
+	// recreates their resource) by the next widget allocating a region before the deferred updates run.  The
+	// fence that swaps in a new render target has to come after its first draw, and a widget freezing releases
+	// its window right after the draw
+	return !bDrawingToSharedAtlas && !UsesMips() && RetiredRenderTarget == nullptr && !bFreezePending;
+}
+
+bool UMeshWidgetComponent::UsesMips() const
+{
+	return MipGeneration != EMeshWidgetMipGeneration::None && !( bUseSharedAtlas && AtlasMaterial );
+}
+
+bool UMeshWidgetComponent::ShouldGenerateMips(uint32 WidgetSignature) const
+{
+	if ( RenderTarget == nullptr || !RenderTarget->bAutoGenerateMips || bDrawingToSharedAtlas )
+	{
+		return false;
+	}
+
+	switch ( MipGeneration )
+	{
+	case EMeshWidgetMipGeneration::EveryRedraw:
+		return true;
+	case EMeshWidgetMipGeneration::OnChange:
+		// Animations don't always show up in the signature
+		return bMipsDirty || WidgetSignature != LastMipsWidgetSignature || ( Widget && Widget->IsAnyAnimationPlaying() );
+	default:
+		return false;
+	}
+}
+
+uint32 UMeshWidgetComponent::ComputeWidgetSignature() const
+{
+	if ( !SlateWindow.IsValid() )
+	{
+		return 0;
+	}
+
+	// Walking the tree is the expensive part, the tick, the prepass check and the draw all ask in the same frame
+	if ( WidgetTreeSignatureFrame != GFrameCounter )
+	{
+		if ( !SignatureTextCache.IsValid() )
+		{
+			SignatureTextCache = MakeShareable(new FMeshWidgetTextCache());
+		}
+
+		SignatureTextCache->BeginPass();
+		WidgetTreeSignature = MeshWidgetSignature::HashWidget(*SlateWindow, 0, SignatureTextCache.Get());
+		WidgetTreeSignatureFrame = GFrameCounter;
+	}
+
+	// The draw size changes within the frame when the desired size is measured
+	return HashCombine(WidgetTreeSignature, GetTypeHash(DrawSize));
+}
+
+void UMeshWidgetComponent::InvalidateWidgetSignature()
+{
+	WidgetTreeSignatureFrame = MAX_uint64;
+}
+
+bool UMeshWidgetComponent::HasWidgetChanged() const
+{
+	if ( RenderTarget == nullptr )
+	{
+		return true;
+	}
+
+	// Animations only advance while the widget is painted
+	if ( Widget && Widget->IsAnyAnimationPlaying() )
+	{
+		return true;
+	}
+
+	if ( MaxUnchangedRedrawInterval > 0.0f && GetWorld()->TimeSince(LastWidgetRenderTime) >= MaxUnchangedRedrawInterval )
+	{
+		return true;
+	}
+
+	return ComputeWidgetSignature() != LastDrawnWidgetSignature;
+}
+
+class FMeshWidgetComponentInstanceData : public FSceneComponentInstanceData
+{
+public:
+	FMeshWidgetComponentInstanceData( const UMeshWidgetComponent* SourceComponent )
+		: FSceneComponentInstanceData(SourceComponent)
+		, WidgetClass ( SourceComponent->GetWidgetClass() )
+		, RenderTarget( SourceComponent->GetRenderTarget() )
+	{}
+
+	virtual void ApplyToComponent(UActorComponent* Component, const ECacheApplyPhase CacheApplyPhase) override
+	{
+		FSceneComponentInstanceData::ApplyToComponent(Component, CacheApplyPhase);
+		CastChecked<UMeshWidgetComponent>(Component)->ApplyComponentInstanceData(this);
+	}
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+	{
+		FSceneComponentInstanceData::AddReferencedObjects(Collector);
+
+		UClass* WidgetUClass = *WidgetClass;
+		Collector.AddReferencedObject(WidgetUClass);
+		Collector.AddReferencedObject(RenderTarget);
+	}
+
+public:
+	TSubclassOf<UUserWidget> WidgetClass;
+	UTextureRenderTarget2D* RenderTarget;
+};
+
+TStructOnScope < FActorComponentInstanceData > UMeshWidgetComponent::GetComponentInstanceData() const
+{
+	return MakeStructOnScope< FActorComponentInstanceData >(this);
+}
+
+void UMeshWidgetComponent::ApplyComponentInstanceData(FMeshWidgetComponentInstanceData* WidgetInstanceData)
+{
+	check(WidgetInstanceData);
+
+	// Note: ApplyComponentInstanceData is called while the component is registered so the rendering thread is already using this component
+	// That means all component state that is modified here must be mirrored on the scene proxy, which will be recreated to receive the changes later due to MarkRenderStateDirty.
+
+	if (GetWidgetClass() != WidgetClass)
+	{
+		return;
+	}
+
+	// Atlas pages belong to the subsystem and our region was released with the old component
+	if ( WidgetInstanceData->RenderTarget == nullptr || bUseSharedAtlas )
+	{
+		return;
+	}
+
+	// The old component returned its render target to the pool, take it back unless someone else got it first
+	UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>();
+	if ( Subsystem && !Subsystem->GetRenderTargetPool()->Reclaim(WidgetInstanceData->RenderTarget) )
+	{
+		return;
+	}
+
+	ReleaseRenderTarget();
+
+	RenderTarget = WidgetInstanceData->RenderTarget;
+	RenderTargetRegion = FIntRect(0, 0, RenderTarget->SizeX, RenderTarget->SizeY);
+	RenderTargetAllocation = RenderTargetRegion;
+	UpdateMaterialInstanceParameters();
+}
+
+#if WITH_EDITORONLY_DATA
+void UMeshWidgetComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	UProperty* Property = PropertyChangedEvent.MemberProperty;
+
+	if( Property && PropertyChangedEvent.ChangeType != EPropertyChangeType::Interactive )
+	{
+		static FName DrawSizeName("DrawSize");
+		static FName PivotName("Pivot");
+		static FName WidgetClassName("WidgetClass");
+		static FName IsOpaqueName("bIsOpaque");
+		static FName IsTwoSidedName("bIsTwoSided");
+		static FName BackgroundColorName("BackgroundColor");
+		static FName TintColorAndOpacityName("TintColorAndOpacity");
+		static FName OpacityFromTextureName("OpacityFromTexture");
+		static FName ParabolaDistortionName(TEXT("ParabolaDistortion"));
+		static FName UseMaterialCursorName( TEXT( "bUseMaterialCursor" ) );
+		static FName CursorTextureName( TEXT( "CursorTexture" ) );
+		static FName CursorSizeName( TEXT( "CursorSize" ) );
+		static FName BlendModeName( TEXT( "BlendMode" ) );
+		static FName UseSharedAtlasName( TEXT( "bUseSharedAtlas" ) );
+		static FName UseResolutionLODName( TEXT( "bUseResolutionLOD" ) );
+		static FName UseDirtyRegionsName( TEXT( "bUseDirtyRegions" ) );
+		static FName UseInvalidationPanelName( TEXT( "bUseInvalidationPanel" ) );
+		static FName AtlasMaterialName( TEXT( "AtlasMaterial" ) );
+		static FName RenderTargetFormatName( TEXT( "RenderTargetFormat" ) );
+		static FName ForceLinearGammaName( TEXT( "bForceLinearGamma" ) );
+		static FName SingleChannelMaterialName( TEXT( "SingleChannelMaterial" ) );
+		static FName MipGenerationName( TEXT( "MipGeneration" ) );
+		static FName MipFilterName( TEXT( "MipFilter" ) );
+
+		auto PropertyName = Property->GetFName();
+
+		if( PropertyName == WidgetClassName )
+		{
+			//in editor rendering is not working so this does nothing
+			//Widget = nullptr;
+			//RenderTarget->UpdateResourceImmediate(true); //clear the old widget render from texture, should probably set base material if set to none
+			//UpdateWidget();
+			MarkRenderStateDirty();
+		}
+		else if ( PropertyName == UseDirtyRegionsName || PropertyName == UseInvalidationPanelName )
+		{
+			// Hosts the content again, with or without the invalidation panel and dirty region host
+			if ( SlateWindow.IsValid() )
+			{
+				CurrentSlateWidget.Reset();
+				UpdateWidget();
+			}
+			RequestRedraw();
+		}
+		else if ( PropertyName == UseResolutionLODName )
+		{
+			UpdateResolutionLOD();
+			RequestRedraw();
+		}
+		else if ( PropertyName == DrawSizeName || PropertyName == PivotName )
+		{
+			MarkRenderStateDirty();
+		}
+		else if ( PropertyName == IsOpaqueName || PropertyName == IsTwoSidedName || PropertyName == BlendModeName || PropertyName == UseSharedAtlasName || PropertyName == AtlasMaterialName )
+		{
+			ValidateRenderTargetFormat();
+			ValidateMaterialCursor();
+			MarkRenderStateDirty();
+		}
+		else if ( PropertyName == RenderTargetFormatName || PropertyName == ForceLinearGammaName || PropertyName == SingleChannelMaterialName )
+		{
+			ValidateRenderTargetFormat();
+			MarkRenderStateDirty();
+		}
+		else if ( PropertyName == MipGenerationName || PropertyName == MipFilterName )
+		{
+			// The render target is swapped for one with the new mip settings on the next draw
+			RequestRedraw();
+		}
+		else if( PropertyName == BackgroundColorName || PropertyName == ParabolaDistortionName )
+		{
+			MarkRenderStateDirty();
+		}
+		else if( PropertyName == TintColorAndOpacityName || PropertyName == OpacityFromTextureName )
 		{
 			MarkRenderStateDirty();
 		}
+		else if ( PropertyName == UseMaterialCursorName || PropertyName == CursorTextureName || PropertyName == CursorSizeName )
+		{
+			ValidateMaterialCursor();
+			UpdateMaterialInstanceParameters();
+		}
+	}
+
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+}
+#endif
+
+void UMeshWidgetComponent::InitWidget()
+{
+	// Don't do any work if Slate is not initialized
+	if ( FSlateApplication::IsInitialized() )
+	{
+		const TSubclassOf<UUserWidget> LODWidgetClass = GetLODWidgetClass(WidgetClassLOD);
+		if ( LODWidgetClass && Widget == nullptr && GetWorld() )
+		{
+			Widget = CreateWidget<UUserWidget>(GetWorld(), LODWidgetClass);
+		}
+		
+#if WITH_EDITOR
+		if ( Widget && !GetWorld()->IsGameWorld() && !bEditTimeUsable )
+		{
+			if( !GEnableVREditorHacks )
+			{
+				// Prevent native ticking of editor component previews
+				Widget->SetDesignerFlags(EWidgetDesignFlags::Designing);
+			}
+		}
+#endif
+	}
+}
+
+void UMeshWidgetComponent::SetOwnerPlayer(ULocalPlayer* LocalPlayer)
+{
+	if ( OwnerPlayer != LocalPlayer )
+	{
+		OwnerPlayer = LocalPlayer;
+	}
+}
+
+ULocalPlayer* UMeshWidgetComponent::GetOwnerPlayer() const
+{
+	return OwnerPlayer ? OwnerPlayer : GEngine->GetLocalPlayerFromControllerId(GetWorld(), 0);
+}
+
+void UMeshWidgetComponent::SetWidget(UUserWidget* InWidget)
+{
+	if( InWidget != nullptr )
+	{
+		SetSlateWidget( nullptr );
+	}
+
+	Widget = InWidget;
+
+	UpdateWidget();
+}
+
+void UMeshWidgetComponent::SetSlateWidget( const TSharedPtr<SWidget>& InSlateWidget )
+{
+	if( Widget != nullptr )
+	{
+		SetWidget( nullptr );
+	}
+
+	if( SlateWidget.IsValid() )
+	{
+		SlateWidget.Reset();
+	}
+
+	SlateWidget = InSlateWidget;
+
+	UpdateWidget();
+}
+
+void UMeshWidgetComponent::UpdateWidget()
+{
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetUpdateWidget);
+
+	// Don't do any work if Slate is not initialized
+	if ( FSlateApplication::IsInitialized() )
+	{
+		TSharedPtr<SWidget> NewSlateWidget;
+		if (Widget)
+		{
+			NewSlateWidget = Widget->TakeWidget();
+		}
+
+		if ( !SlateWindow.IsValid() )
+		{
+			SlateWindow = SNew(SVirtualWindow).Size(DrawSize);
+			SlateWindow->SetIsFocusable(bWindowFocusable);
+
+			// Keep the content from spilling into the regions of other widgets in the atlas
+			if ( bUseSharedAtlas )
+			{
+				SlateWindow->SetClipping(EWidgetClipping::ClipToBounds);
+			}
+
+			RegisterWindow();
+		}
+
+		if ( !HitTestGrid.IsValid() )
+		{
+			HitTestGrid = MakeShareable(new FHittestGrid);
+		}
+
+		SlateWindow->Resize(DrawSize);
+
+		if ( NewSlateWidget.IsValid() )
+		{
+			if ( NewSlateWidget != CurrentSlateWidget )
+			{
+				CurrentSlateWidget = NewSlateWidget;
+				SetWindowContent(NewSlateWidget.ToSharedRef());
+			}
+		}
+		else if( SlateWidget.IsValid() )
+		{
+			if ( SlateWidget != CurrentSlateWidget )
+			{
+				CurrentSlateWidget = SlateWidget;
+				SetWindowContent(SlateWidget.ToSharedRef());
+			}
+		}
+		else
+		{
+			CurrentSlateWidget = SNullWidget::NullWidget;
+			SetWindowContent( SNullWidget::NullWidget );
+		}
+	}
+}
+
+void UMeshWidgetComponent::SetWindowContent(const TSharedRef<SWidget>& InContent)
+{
+	bFullRepaintNeeded = true;
+	InvalidateWidgetSignature();
+
+	TSharedRef<SWidget> Content = InContent;
+
+	if ( bUseInvalidationPanel )
+	{
+		if ( !InvalidationPanel.IsValid() )
+		{
+			InvalidationPanel = SNew(SMeshWidgetInvalidationPanel);
+		}
+
+		InvalidationPanel->SetContent(Content);
+		Content = InvalidationPanel.ToSharedRef();
+	}
+	else
+	{
+		InvalidationPanel.Reset();
+	}
+
+	if ( bUseDirtyRegions )
+	{
+		if ( !DirtyRegionHost.IsValid() )
+		{
+			DirtyRegionHost = SNew(SMeshWidgetDirtyRegion);
+			DirtyRegionTracker = MakeShareable(new FMeshWidgetDirtyRegionTracker);
+		}
+
+		DirtyRegionHost->SetContent(Content);
+		SlateWindow->SetContent(DirtyRegionHost.ToSharedRef());
+	}
+	else
+	{
+		// The host would keep the content as its child
+		DirtyRegionHost.Reset();
+		DirtyRegionTracker.Reset();
+
+		SlateWindow->SetContent(Content);
+	}
+}
+
+int32 UMeshWidgetComponent::GetInvalidationCacheHits() const
+{
+	return InvalidationPanel.IsValid() ? InvalidationPanel->GetNumCacheHits() : 0;
+}
+
+int32 UMeshWidgetComponent::GetInvalidationCacheMisses() const
+{
+	return InvalidationPanel.IsValid() ? InvalidationPanel->GetNumCacheMisses() : 0;
+}
+
+void UMeshWidgetComponent::ResetInvalidationCacheCounters()
+{
+	if ( InvalidationPanel.IsValid() )
+	{
+		InvalidationPanel->ResetCacheCounters();
+	}
+}
+
+bool UMeshWidgetComponent::UpdateResolutionLOD()
+{
+	int32 NewResolutionLOD = 0;
+
+	UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>();
+	if ( bUseResolutionLOD && Subsystem && Subsystem->GetViews().Num() > 0 )
+	{
+		// The bounds are at least as large as the widget, so this never undersamples
+		const float Scale = GetProjectedSizeWithMirrors() / FMath::Max(1, FMath::Max(DrawSize.X, DrawSize.Y));
+
+		NewResolutionLOD = Scale > 0.0f ? FMath::Clamp(FMath::FloorToInt(-FMath::Log2(Scale)), 0, MaxResolutionLOD) : MaxResolutionLOD;
+
+		// Don't flip back and forth at the boundary, only lower the resolution once clearly past it
+		const float Hysteresis = 0.85f;
+		if ( NewResolutionLOD > ResolutionLOD && Scale > FMath::Pow(0.5f, NewResolutionLOD) * Hysteresis )
+		{
+			NewResolutionLOD--;
+		}
+	}
+
+	if ( NewResolutionLOD != ResolutionLOD )
+	{
+		ResolutionLOD = NewResolutionLOD;
+		return true;
+	}
+
+	return false;
+}
+
+float UMeshWidgetComponent::GetProjectedSizeWithMirrors() const
+{
+	UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>();
+	if ( Subsystem == nullptr )
+	{
+		return 0.0f;
+	}
+
+	// The largest mirror decides
+	float ProjectedSize = Subsystem->GetProjectedSize(this);
+	for ( const UMeshWidgetComponent* Mirror : Mirrors )
+	{
+		if ( Mirror )
+		{
+			ProjectedSize = FMath::Max(ProjectedSize, Subsystem->GetProjectedSize(Mirror));
+		}
 	}
 
-	Super::PostEditChangeProperty(PropertyChangedEvent);
+	return ProjectedSize;
 }
-#endif
 
-void UMeshWidgetComponent::InitWidget()
+TSubclassOf<UUserWidget> UMeshWidgetComponent::GetLODWidgetClass(int32 InWidgetClassLOD) const
 {
-	// Don't do any work if Slate is not initialized
-	if ( FSlateApplication::IsInitialized() )
+	return WidgetClassLODs.IsValidIndex(InWidgetClassLOD - 1) ? WidgetClassLODs[InWidgetClassLOD - 1].WidgetClass : WidgetClass;
+}
+
+bool UMeshWidgetComponent::UpdateWidgetClassLOD()
+{
+	// Widgets set with SetWidget can't be created again, and a widget frozen by Freeze or the live widget limit stays frozen
+	if ( WidgetClassLODs.Num() == 0 || WidgetClass == nullptr || ( bFrozen && !bFrozenByClassLOD ) || bFreezePending )
 	{
-		if ( WidgetClass && Widget == nullptr && GetWorld() )
+		return false;
+	}
+
+	UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>();
+	if ( Subsystem == nullptr || Subsystem->GetViews().Num() == 0 )
+	{
+		return false;
+	}
+
+	const float ProjectedSize = GetProjectedSizeWithMirrors();
+
+	// Don't flip back and forth at a threshold, only move to a simpler class once clearly past it
+	const float Hysteresis = 0.85f;
+	int32 NewWidgetClassLOD = 0;
+	for ( int32 LODIndex = 0; LODIndex < WidgetClassLODs.Num(); ++LODIndex )
+	{
+		const float Threshold = WidgetClassLODs[LODIndex].ProjectedSize * ( LODIndex + 1 > WidgetClassLOD ? Hysteresis : 1.0f );
+		if ( ProjectedSize < Threshold )
 		{
-			Widget = CreateWidget<UUserWidget>(GetWorld(), WidgetClass);
+			NewWidgetClassLOD = LODIndex + 1;
 		}
-		
-#if WITH_EDITOR
-		if ( Widget && !GetWorld()->IsGameWorld() && !bEditTimeUsable )
+	}
+
+	if ( NewWidgetClassLOD == WidgetClassLOD )
+	{
+		return false;
+	}
+
+	UUserWidget* PreviousWidget = Widget;
+	UObject* PreviousLODState = LODState;
+	const TSubclassOf<UUserWidget> NewWidgetClass = GetLODWidgetClass(NewWidgetClassLOD);
+
+	if ( NewWidgetClass == nullptr )
+	{
+		// A static impostor, the texture keeps the last frame drawn by the previous class.  Only the state the
+		// widget saves and its class are kept, so the widget tree is released along with the Slate resources
+		if ( !bFrozen )
 		{
-			if( !GEnableVREditorHacks )
+			Freeze();
+			if ( !bFrozen )
 			{
-				// Prevent native ticking of editor component previews
-				Widget->SetDesignerFlags(EWidgetDesignFlags::Designing);
+				return false;
 			}
+
+			LODState = SaveLODStateOf(PreviousWidget);
+			LODStateWidgetClass = PreviousWidget ? PreviousWidget->GetClass() : nullptr;
 		}
-#endif
+
+		WidgetClassLOD = NewWidgetClassLOD;
+		bFrozenByClassLOD = true;
+		return true;
 	}
-}
 
-void UMeshWidgetComponent::SetOwnerPlayer(ULocalPlayer* LocalPlayer)
-{
-	if ( OwnerPlayer != LocalPlayer )
+	WidgetClassLOD = NewWidgetClassLOD;
+	LODState = nullptr;
+	LODStateWidgetClass = nullptr;
+
+	if ( bFrozen )
 	{
-		OwnerPlayer = LocalPlayer;
+		bFrozenByClassLOD = false;
+
+		// Creates the widget of the new class
+		Thaw();
+	}
+	else
+	{
+		Widget = nullptr;
+		RecreateWidgetResources();
+	}
+
+	if ( PreviousWidget )
+	{
+		CopyLODStateFrom(PreviousWidget);
+	}
+	else
+	{
+		RestoreLODStateFrom(PreviousLODState);
 	}
+
+	return true;
 }
 
-ULocalPlayer* UMeshWidgetComponent::GetOwnerPlayer() const
+FLinearColor UMeshWidgetComponent::GetRenderTargetClearColor() const
 {
-	return OwnerPlayer ? OwnerPlayer : GEngine->GetLocalPlayerFromControllerId(GetWorld(), 0);
+	FLinearColor ActualBackgroundColor = BackgroundColor;
+	switch ( BlendMode )
+	{
+	case EWidgetBlendMode::Opaque:
+		ActualBackgroundColor.A = 1.0f;
+		break;
+	case EWidgetBlendMode::Masked:
+		ActualBackgroundColor.A = 0.0f;
+		break;
+	}
+
+	switch ( GetRenderTargetPixelFormat() )
+	{
+	case PF_G8:
+	{
+		// Only red is stored, the single channel material shows it as gray
+		const float Luminance = ActualBackgroundColor.ComputeLuminance();
+		ActualBackgroundColor = FLinearColor(Luminance, Luminance, Luminance, 1.0f);
+		break;
+	}
+	case PF_FloatR11G11B10:
+		ActualBackgroundColor.A = 1.0f;
+		break;
+	default:
+		break;
+	}
+
+	return ActualBackgroundColor;
 }
 
-void UMeshWidgetComponent::SetWidget(UUserWidget* InWidget)
+namespace MeshWidgetRenderTargetFormat
 {
-	if( InWidget != nullptr )
+	static EPixelFormat ToPixelFormat(EMeshWidgetRenderTargetFormat Format)
 	{
-		SetSlateWidget( nullptr );
+		switch ( Format )
+		{
+		case EMeshWidgetRenderTargetFormat::RGB10A2:
+			return PF_A2B10G10R10;
+		case EMeshWidgetRenderTargetFormat::R8:
+			return PF_G8;
+		case EMeshWidgetRenderTargetFormat::RGBA16F:
+			return PF_FloatRGBA;
+		case EMeshWidgetRenderTargetFormat::RG11B10F:
+			return PF_FloatR11G11B10;
+		default:
+			return PF_B8G8R8A8;
+		}
 	}
 
-	Widget = InWidget;
-
-	UpdateWidget();
+	/** @return Bits of alpha the format stores */
+	static int32 GetAlphaBits(EMeshWidgetRenderTargetFormat Format)
+	{
+		switch ( Format )
+		{
+		case EMeshWidgetRenderTargetFormat::RGB10A2:
+			return 2;
+		case EMeshWidgetRenderTargetFormat::R8:
+		case EMeshWidgetRenderTargetFormat::RG11B10F:
+			return 0;
+		case EMeshWidgetRenderTargetFormat::RGBA16F:
+			return 16;
+		default:
+			return 8;
+		}
+	}
 }
 
-void UMeshWidgetComponent::SetSlateWidget( const TSharedPtr<SWidget>& InSlateWidget )
+FString UMeshWidgetComponent::ComputeRenderTargetFormatError() const
 {
-	if( Widget != nullptr )
+	using namespace MeshWidgetRenderTargetFormat;
+
+	if ( RenderTargetFormat == EMeshWidgetRenderTargetFormat::RGBA8 )
 	{
-		SetWidget( nullptr );
+		return FString();
 	}
 
-	if( SlateWidget.IsValid() )
+	const EPixelFormat PixelFormat = ToPixelFormat(RenderTargetFormat);
+	if ( !GPixelFormats[PixelFormat].Supported )
 	{
-		SlateWidget.Reset();
+		return FString::Printf(TEXT("%s is not supported by this platform"), GPixelFormats[PixelFormat].Name);
 	}
 
-	SlateWidget = InSlateWidget;
+	const int32 AlphaBits = GetAlphaBits(RenderTargetFormat);
+	if ( BlendMode == EWidgetBlendMode::Transparent && AlphaBits < 8 )
+	{
+		return TEXT("the Transparent blend mode needs at least 8 bits of alpha");
+	}
 
-	UpdateWidget();
+	if ( BlendMode == EWidgetBlendMode::Masked && AlphaBits == 0 )
+	{
+		return TEXT("the Masked blend mode needs an alpha channel");
+	}
+
+	if ( RenderTargetFormat == EMeshWidgetRenderTargetFormat::R8 && SingleChannelMaterial == nullptr )
+	{
+		return TEXT("R8 needs a SingleChannelMaterial");
+	}
+
+	return FString();
 }
 
-void UMeshWidgetComponent::UpdateWidget()
+void UMeshWidgetComponent::ValidateRenderTargetFormat()
 {
-	// Don't do any work if Slate is not initialized
-	if ( FSlateApplication::IsInitialized() )
+	// Atlas pages are shared, so they keep the default format
+	if ( bUseSharedAtlas && AtlasMaterial )
 	{
-		TSharedPtr<SWidget> NewSlateWidget;
-		if (Widget)
-		{
-			NewSlateWidget = Widget->TakeWidget();
-		}
+		RenderTargetFormatError.Reset();
+		RenderTargetPixelFormat = PF_B8G8R8A8;
+		return;
+	}
 
-		if ( !SlateWindow.IsValid() )
-		{
-			SlateWindow = SNew(SVirtualWindow).Size(DrawSize);
-			SlateWindow->SetIsFocusable(bWindowFocusable);
-			RegisterWindow();
-		}
+	RenderTargetFormatError = ComputeRenderTargetFormatError();
+	RenderTargetPixelFormat = RenderTargetFormatError.IsEmpty() ? MeshWidgetRenderTargetFormat::ToPixelFormat(RenderTargetFormat) : PF_B8G8R8A8;
 
-		if ( !HitTestGrid.IsValid() )
-		{
-			HitTestGrid = MakeShareable(new FHittestGrid);
-		}
+	if ( !RenderTargetFormatError.IsEmpty() )
+	{
+		UE_LOG(LogMeshWidget, Warning, TEXT("%s: Render target format %s can't be used, %s.  Falling back to RGBA8."),
+			*GetPathName(), *StaticEnum<EMeshWidgetRenderTargetFormat>()->GetNameStringByValue((int64)RenderTargetFormat), *RenderTargetFormatError);
+	}
+}
 
-		SlateWindow->Resize(DrawSize);
+void UMeshWidgetComponent::ValidateMaterialCursor() const
+{
+	const UMaterialInterface* BaseMaterial = bUseMaterialCursor ? GetBaseMaterial() : nullptr;
+	if ( BaseMaterial == nullptr )
+	{
+		return;
+	}
 
-		if ( NewSlateWidget.IsValid() )
-		{
-			if ( NewSlateWidget != CurrentSlateWidget )
-			{
-				CurrentSlateWidget = NewSlateWidget;
-				SlateWindow->SetContent(NewSlateWidget.ToSharedRef());
-			}
-		}
-		else if( SlateWidget.IsValid() )
-		{
-			if ( SlateWidget != CurrentSlateWidget )
-			{
-				CurrentSlateWidget = SlateWidget;
-				SlateWindow->SetContent(SlateWidget.ToSharedRef());
-			}
-		}
-		else
-		{
-			CurrentSlateWidget = SNullWidget::NullWidget;
-			SlateWindow->SetContent( SNullWidget::NullWidget );
-		}
+	// Setting a parameter the material doesn't have does nothing, so the cursor would silently never show
+	UTexture* Texture = nullptr;
+	FLinearColor Value;
+	if ( !BaseMaterial->GetTextureParameterValue(FMaterialParameterInfo(MeshWidgetMaterialParameters::CursorTexture), Texture)
+		|| !BaseMaterial->GetVectorParameterValue(FMaterialParameterInfo(MeshWidgetMaterialParameters::CursorUV), Value)
+		|| !BaseMaterial->GetVectorParameterValue(FMaterialParameterInfo(MeshWidgetMaterialParameters::CursorSize), Value) )
+	{
+		UE_LOG(LogMeshWidget, Warning, TEXT("%s: bUseMaterialCursor is set, but material %s has no CursorTexture, CursorUV and CursorSize parameters.  The cursor won't be drawn."),
+			*GetPathName(), *BaseMaterial->GetPathName());
 	}
 }
 
-void UMeshWidgetComponent::UpdateRenderTarget(FIntPoint DesiredRenderTargetSize)
+FLinearColor UMeshWidgetComponent::GetRenderTargetRegionScaleOffset() const
 {
-	bool bWidgetRenderStateDirty = false;
-	bool bClearColorChanged = false;
+	// The material samples the retired render target until the new one has been drawn
+	const UTextureRenderTarget2D* DisplayedRenderTarget = GetDisplayedRenderTarget();
+	const FIntRect& DisplayedRegion = RetiredRenderTarget ? RetiredRenderTargetRegion : RenderTargetRegion;
 
-	FLinearColor ActualBackgroundColor = BackgroundColor;
-	switch ( BlendMode )
+	if ( DisplayedRenderTarget == nullptr || DisplayedRenderTarget->SizeX == 0 || DisplayedRenderTarget->SizeY == 0 )
 	{
-	case EWidgetBlendMode::Opaque:
-		ActualBackgroundColor.A = 1.0f;
-	case EWidgetBlendMode::Masked:
-		ActualBackgroundColor.A = 0.0f;
+		return FLinearColor(1.0f, 1.0f, 0.0f, 0.0f);
 	}
 
+	const float SizeX = DisplayedRenderTarget->SizeX;
+	const float SizeY = DisplayedRenderTarget->SizeY;
+
+	return FLinearColor(
+		DisplayedRegion.Width() / SizeX,
+		DisplayedRegion.Height() / SizeY,
+		DisplayedRegion.Min.X / SizeX,
+		DisplayedRegion.Min.Y / SizeY);
+}
+
+void UMeshWidgetComponent::UpdateRenderTarget(FIntPoint DesiredRenderTargetSize, FIntPoint UsedRenderTargetSize)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetUpdateRenderTarget);
+
+	const FLinearColor ActualBackgroundColor = GetRenderTargetClearColor();
+
 	if ( DesiredRenderTargetSize.X != 0 && DesiredRenderTargetSize.Y != 0 )
 	{
-		if ( RenderTarget == nullptr )
+		// Pack into a shared atlas page, unless we already fell back to a render target of our own
+		if ( bUseSharedAtlas && AtlasMaterial && ( RenderTarget == nullptr || bDrawingToSharedAtlas ) )
 		{
-			RenderTarget = NewObject<UTextureRenderTarget2D>(this);
-			RenderTarget->ClearColor = ActualBackgroundColor;
-
-			bClearColorChanged = bWidgetRenderStateDirty = true;
+			if ( RenderTarget == nullptr || RenderTargetAllocation.Size() != DesiredRenderTargetSize )
+			{
+				ReleaseRenderTarget();
 
-			RenderTarget->InitCustomFormat(DesiredRenderTargetSize.X, DesiredRenderTargetSize.Y, PF_B8G8R8A8, false);
+				if ( UMeshWidgetSubsystem* Subsystem = GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() )
+				{
+					RenderTarget = Subsystem->AllocateAtlasRegion(DesiredRenderTargetSize, RenderTargetAllocation);
+				}
 
-			MaterialInstance->SetTextureParameterValue("SlateUI", RenderTarget);
+				bDrawingToSharedAtlas = RenderTarget != nullptr;
+			}
 		}
-		else
+
+		if ( !bDrawingToSharedAtlas )
 		{
-			// Update the format
-			if ( RenderTarget->SizeX != DesiredRenderTargetSize.X || RenderTarget->SizeY != DesiredRenderTargetSize.Y )
-			{
-				RenderTarget->InitCustomFormat(DesiredRenderTargetSize.X, DesiredRenderTargetSize.Y, PF_B8G8R8A8, false);
-				RenderTarget->UpdateResourceImmediate(false);
-				bWidgetRenderStateDirty = true;
-			}
+			const FMeshWidgetRenderTargetDesc DesiredDesc(DesiredRenderTargetSize, GetRenderTargetPixelFormat(), bForceLinearGamma, ActualBackgroundColor, UsesMips(), MipFilter);
 
-			// Update the clear color
-			if ( RenderTarget->ClearColor != ActualBackgroundColor )
+			// Size, format and clear color are baked into the resource, so a change swaps in a matching render target
+			// from the pool.  The current one stays on screen until the new one has been drawn
+			if ( RenderTarget == nullptr || !( FMeshWidgetRenderTargetDesc(RenderTarget) == DesiredDesc ) )
 			{
-				RenderTarget->ClearColor = ActualBackgroundColor;
-				bClearColorChanged = bWidgetRenderStateDirty = true;
+				if ( RetiredRenderTarget == nullptr )
+				{
+					RetiredRenderTarget = RenderTarget;
+					RetiredRenderTargetRegion = RenderTargetRegion;
+				}
+				else if ( UMeshWidgetSubsystem* Subsystem = RenderTarget ? GetWorld()->GetSubsystem<UMeshWidgetSubsystem>() : nullptr )
+				{
+					// Replaced again before it was ever shown
+					Subsystem->GetRenderTargetPool()->Release(RenderTarget);
+				}
+
+				RenderTarget = AcquireRenderTarget(DesiredRenderTargetSize, ActualBackgroundColor);
+				bRenderTargetSwapFenceBegun = false;
+				bMipsDirty = true;
 			}
 
-			if ( bWidgetRenderStateDirty )
-			{
-				RenderTarget->UpdateResource();
-			}
+			RenderTargetAllocation = FIntRect(FIntPoint::ZeroValue, DesiredRenderTargetSize);
 		}
 	}
 
 	if ( RenderTarget )
 	{
-		// If the clear color of the render target changed, update the BackColor of the material to match
-		if ( bClearColorChanged )
-		{
-			MaterialInstance->SetVectorParameterValue("BackColor", RenderTarget->ClearColor);
-		}
-
-		static FName ParabolaDistortionName(TEXT("ParabolaDistortion"));
-
-		float CurrentParabolaValue;
-		if ( MaterialInstance->GetScalarParameterValue(ParabolaDistortionName, CurrentParabolaValue) && CurrentParabolaValue != ParabolaDistortion )
-		{
-			MaterialInstance->SetScalarParameterValue(ParabolaDistortionName, ParabolaDistortion);
-		}
-
-		if ( bWidgetRenderStateDirty )
-		{
-			MarkRenderStateDirty();
-		}
+		const FIntPoint AllocationSize = RenderTargetAllocation.Size();
+		const FIntPoint UsedSize = UsedRenderTargetSize.X > 0 && UsedRenderTargetSize.Y > 0 ? UsedRenderTargetSize.ComponentMin(AllocationSize) : AllocationSize;
+		RenderTargetRegion = FIntRect(RenderTargetAllocation.Min, RenderTargetAllocation.Min + UsedSize);
+
+		// Only the values that changed since the last draw reach the material, and updating them is enough for
+		// the existing scene proxy to pick up a new render target, so it isn't recreated
+		SetMaterialTextureParameter(MeshWidgetMaterialParameters::SlateUI, GetDisplayedRenderTarget());
+		SetMaterialVectorParameter(MeshWidgetMaterialParameters::BackColor, ActualBackgroundColor);
+		SetMaterialScalarParameter(MeshWidgetMaterialParameters::ParabolaDistortion, ParabolaDistortion);
+		SetMaterialVectorParameter(MeshWidgetMaterialParameters::AtlasUVScaleOffset, GetRenderTargetRegionScaleOffset());
+
+		NotifyMirrors();
 	}
 }
 
 FVector2D UMeshWidgetComponent::GetLocalHitLocation(const FHitResult& Hit) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetGetLocalHitLocation);
+
 	FVector2D UV;
 	UGameplayStatics::FindCollisionUV(Hit, 0, UV);
-	UE_LOG(LogTemp, Warning, TEXT("%f %f"), UV.X, UV.Y);
 
-	return FVector2D(DrawSize.X * UV.X, DrawSize.Y * UV.Y);
+	// The UVs of a mirror map onto the widget of its source
+	const FIntPoint HitDrawSize = MirrorSource ? MirrorSource->DrawSize : DrawSize;
+	return FVector2D(HitDrawSize.X * UV.X, HitDrawSize.Y * UV.Y);
 }
 
 UUserWidget* UMeshWidgetComponent::GetUserWidgetObject() const
 {
-	return Widget;
+	return MirrorSource ? MirrorSource->GetUserWidgetObject() : Widget;
 }
 
 UTextureRenderTarget2D* UMeshWidgetComponent::GetRenderTarget() const
@@ -593,14 +2208,48 @@ const TSharedPtr<SWidget>& UMeshWidgetComponent::GetSlateWidget() const
 	return SlateWidget;
 }
 
+FVector2D UMeshWidgetComponent::LocalToWindowLocation(const FVector2D& LocalLocation) const
+{
+	if ( MirrorSource )
+	{
+		return MirrorSource->LocalToWindowLocation(LocalLocation);
+	}
+
+	return LocalLocation * CurrentDrawScale + FVector2D(RenderTargetRegion.Min);
+}
+
 TArray<FWidgetAndPointer> UMeshWidgetComponent::GetHitWidgetPath(const FHitResult& Hit, bool bIgnoreEnabledStatus, float CursorRadius)
 {
-	FVector2D LocalHitLocation = GetLocalHitLocation(Hit);
+	// Input on a mirror goes to the widget of its source, through the source's hit test grid
+	if ( MirrorSource )
+	{
+		return MirrorSource->GetHitWidgetPathAtLocation(GetLocalHitLocation(Hit), bIgnoreEnabledStatus, CursorRadius);
+	}
+
+	return GetHitWidgetPathAtLocation(GetLocalHitLocation(Hit), bIgnoreEnabledStatus, CursorRadius);
+}
+
+TArray<FWidgetAndPointer> UMeshWidgetComponent::GetHitWidgetPathAtLocation(const FVector2D& LocalHitLocation, bool bIgnoreEnabledStatus, float CursorRadius)
+{
+	// The hit test grid is filled by the next draw, so the widget starts reacting a frame later.  A widget frozen by
+	// its class LOD thaws once it is large enough on screen again
+	if ( bFrozen && bThawOnHover && !bFrozenByClassLOD && !bFrozenByLiveWidgetLimit )
+	{
+		Thaw();
+	}
+
+	// Likewise a dormant widget is created by the hover, and reacts once it has been drawn
+	if ( bWidgetDormant )
+	{
+		WakeWidget();
+	}
+
+	FVector2D WindowHitLocation = LocalToWindowLocation(LocalHitLocation);
 
 	TSharedRef<FVirtualPointerPosition> VirtualMouseCoordinate = MakeShareable( new FVirtualPointerPosition );
 
-	VirtualMouseCoordinate->CurrentCursorPosition = LocalHitLocation;
-	VirtualMouseCoordinate->LastCursorPosition = LastLocalHitLocation;
+	VirtualMouseCoordinate->CurrentCursorPosition = WindowHitLocation;
+	VirtualMouseCoordinate->LastCursorPosition = LocalToWindowLocation(LastLocalHitLocation);
 
 	// Cache the location of the hit
 	LastLocalHitLocation = LocalHitLocation;
@@ -608,7 +2257,10 @@ TArray<FWidgetAndPointer> UMeshWidgetComponent::GetHitWidgetPath(const FHitResul
 	TArray<FWidgetAndPointer> ArrangedWidgets;
 	if ( HitTestGrid.IsValid() )
 	{
-		ArrangedWidgets = HitTestGrid->GetBubblePath( LocalHitLocation, CursorRadius, bIgnoreEnabledStatus );
+		SCOPE_CYCLE_COUNTER(STAT_MeshWidgetGetBubblePath);
+		MESHWIDGET_SCOPED_NAMED_EVENT("MeshWidget GetBubblePath", this);
+
+		ArrangedWidgets = HitTestGrid->GetBubblePath( WindowHitLocation, CursorRadius, bIgnoreEnabledStatus );
 
 		for( FWidgetAndPointer& ArrangedWidget : ArrangedWidgets )
 		{
@@ -636,13 +2288,18 @@ void UMeshWidgetComponent::SetDrawSize(FVector2D Size)
 	if ( NewDrawSize != DrawSize )
 	{
 		DrawSize = NewDrawSize;
-		MarkRenderStateDirty();
-		RecreatePhysicsState();
+		RequestRedraw();
 	}
 }
 
 void UMeshWidgetComponent::RequestRedraw()
 {
+	if ( MirrorSource )
+	{
+		MirrorSource->RequestRedraw();
+		return;
+	}
+
 	bRedrawRequested = true;
 }
 
@@ -651,6 +2308,20 @@ void UMeshWidgetComponent::SetBlendMode( const EWidgetBlendMode NewBlendMode )
 	if( NewBlendMode != this->BlendMode )
 	{
 		this->BlendMode = NewBlendMode;
+		ValidateRenderTargetFormat();
+		if( IsRegistered() )
+		{
+			MarkRenderStateDirty();
+		}
+	}
+}
+
+void UMeshWidgetComponent::SetRenderTargetFormat( const EMeshWidgetRenderTargetFormat NewRenderTargetFormat )
+{
+	if( NewRenderTargetFormat != RenderTargetFormat )
+	{
+		RenderTargetFormat = NewRenderTargetFormat;
+		ValidateRenderTargetFormat();
 		if( IsRegistered() )
 		{
 			MarkRenderStateDirty();
@@ -744,6 +2415,22 @@ UMaterialInterface* UMeshWidgetComponent::GetMaterial(int32 MaterialIndex) const
 
 UMaterialInterface* UMeshWidgetComponent::GetBaseMaterial() const
 {
+	// Sampling the source's render target needs the material its atlas or format calls for
+	if ( MirrorSource && ( MirrorSource->IsUsingSharedAtlas() || MirrorSource->GetRenderTargetPixelFormat() == PF_G8 ) )
+	{
+		return MirrorSource->GetBaseMaterial();
+	}
+
+	if ( bUseSharedAtlas && AtlasMaterial )
+	{
+		return AtlasMaterial;
+	}
+
+	if ( GetRenderTargetPixelFormat() == PF_G8 )
+	{
+		return SingleChannelMaterial;
+	}
+
 	switch ( BlendMode )
 	{
 	case EWidgetBlendMode::Opaque:
@@ -766,11 +2453,87 @@ int32 UMeshWidgetComponent::GetNumMaterials() const
 
 void UMeshWidgetComponent::UpdateMaterialInstanceParameters()
 {
-	if ( MaterialInstance )
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetUpdateMaterialParameters);
+
+	// A mirror samples the render target of its source
+	const UMeshWidgetComponent* DrawingComponent = MirrorSource ? MirrorSource : this;
+
+	SetMaterialTextureParameter(MeshWidgetMaterialParameters::SlateUI, DrawingComponent->GetDisplayedRenderTarget());
+	SetMaterialVectorParameter(MeshWidgetMaterialParameters::BackColor, GetRenderTargetClearColor());
+	SetMaterialVectorParameter(MeshWidgetMaterialParameters::TintColorAndOpacity, TintColorAndOpacity);
+	SetMaterialScalarParameter(MeshWidgetMaterialParameters::OpacityFromTexture, OpacityFromTexture);
+	SetMaterialScalarParameter(MeshWidgetMaterialParameters::ParabolaDistortion, ParabolaDistortion);
+	SetMaterialVectorParameter(MeshWidgetMaterialParameters::AtlasUVScaleOffset, DrawingComponent->GetRenderTargetRegionScaleOffset());
+
+	if ( bUseMaterialCursor )
+	{
+		// The cursor is placed over the UVs of this component, which a mirror shares with its source
+		const FVector2D CursorDrawSize = FVector2D(MirrorSource ? MirrorSource->DrawSize : DrawSize);
+		const FVector2D CursorUVSize = CursorSize / FVector2D(FMath::Max(1.0f, CursorDrawSize.X), FMath::Max(1.0f, CursorDrawSize.Y));
+
+		SetMaterialTextureParameter(MeshWidgetMaterialParameters::CursorTexture, CursorTexture);
+		SetMaterialVectorParameter(MeshWidgetMaterialParameters::CursorSize, FLinearColor(CursorUVSize.X, CursorUVSize.Y, 0.0f, 0.0f));
+		SetMaterialVectorParameter(MeshWidgetMaterialParameters::CursorUV, CursorUV);
+	}
+}
+
+void UMeshWidgetComponent::SetMaterialCursorLocation(const FVector2D& LocalLocation)
+{
+	const FVector2D CursorDrawSize = FVector2D(MirrorSource ? MirrorSource->DrawSize : DrawSize);
+	CursorUV = FLinearColor(LocalLocation.X / FMath::Max(1.0f, CursorDrawSize.X), LocalLocation.Y / FMath::Max(1.0f, CursorDrawSize.Y), 1.0f, 0.0f);
+
+	SetMaterialVectorParameter(MeshWidgetMaterialParameters::CursorUV, CursorUV);
+}
+
+void UMeshWidgetComponent::HideMaterialCursor()
+{
+	CursorUV.B = 0.0f;
+
+	SetMaterialVectorParameter(MeshWidgetMaterialParameters::CursorUV, CursorUV);
+}
+
+void UMeshWidgetComponent::SetMaterialScalarParameter(FName ParameterName, float Value)
+{
+	FMeshWidgetMaterialInstance* CachedInstance = MaterialInstance ? MaterialInstanceCache.Find(MaterialInstanceBase) : nullptr;
+	if ( CachedInstance )
 	{
-		MaterialInstance->SetTextureParameterValue("SlateUI", RenderTarget);
-		MaterialInstance->SetVectorParameterValue("TintColorAndOpacity", TintColorAndOpacity);
-		MaterialInstance->SetScalarParameterValue("OpacityFromTexture", OpacityFromTexture);
+		const float* CachedValue = CachedInstance->ScalarValues.Find(ParameterName);
+		if ( CachedValue == nullptr || *CachedValue != Value )
+		{
+			INC_DWORD_STAT(STAT_MeshWidgetNumMaterialParametersSet);
+			MaterialInstance->SetScalarParameterValue(ParameterName, Value);
+			CachedInstance->ScalarValues.Add(ParameterName, Value);
+		}
+	}
+}
+
+void UMeshWidgetComponent::SetMaterialVectorParameter(FName ParameterName, const FLinearColor& Value)
+{
+	FMeshWidgetMaterialInstance* CachedInstance = MaterialInstance ? MaterialInstanceCache.Find(MaterialInstanceBase) : nullptr;
+	if ( CachedInstance )
+	{
+		const FLinearColor* CachedValue = CachedInstance->VectorValues.Find(ParameterName);
+		if ( CachedValue == nullptr || *CachedValue != Value )
+		{
+			INC_DWORD_STAT(STAT_MeshWidgetNumMaterialParametersSet);
+			MaterialInstance->SetVectorParameterValue(ParameterName, Value);
+			CachedInstance->VectorValues.Add(ParameterName, Value);
+		}
+	}
+}
+
+void UMeshWidgetComponent::SetMaterialTextureParameter(FName ParameterName, UTexture* Value)
+{
+	FMeshWidgetMaterialInstance* CachedInstance = MaterialInstance ? MaterialInstanceCache.Find(MaterialInstanceBase) : nullptr;
+	if ( CachedInstance )
+	{
+		const UTexture* const* CachedValue = CachedInstance->TextureValues.Find(ParameterName);
+		if ( CachedValue == nullptr || *CachedValue != Value )
+		{
+			INC_DWORD_STAT(STAT_MeshWidgetNumMaterialParametersSet);
+			MaterialInstance->SetTextureParameterValue(ParameterName, Value);
+			CachedInstance->TextureValues.Add(ParameterName, Value);
+		}
 	}
 }
 
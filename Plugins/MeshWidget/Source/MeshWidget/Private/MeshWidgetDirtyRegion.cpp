@@ -0,0 +1,170 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "MeshWidgetDirtyRegion.h"
+#include "MeshWidgetSignature.h"
+
+#include "Rendering/DrawElements.h"
+
+namespace MeshWidgetDirtyRegion
+{
+	static FBox2D GetPaintBox(const SWidget& InWidget)
+	{
+		const FSlateRect PaintRect = InWidget.GetPaintSpaceGeometry().GetRenderBoundingRect();
+		return FBox2D(FVector2D(PaintRect.Left, PaintRect.Top), FVector2D(PaintRect.Right, PaintRect.Bottom));
+	}
+
+	static int32 GetNumChildren(const SWidget& InWidget)
+	{
+		FChildren* Children = const_cast<SWidget&>(InWidget).GetChildren();
+		return Children ? Children->Num() : 0;
+	}
+}
+
+void SMeshWidgetDirtyRegion::Construct(const FArguments& InArgs)
+{
+	// Only a host, the hosted widgets get the hits
+	SetVisibility(EVisibility::SelfHitTestInvisible);
+
+	ChildSlot
+	[
+		InArgs._Content.Widget
+	];
+}
+
+void SMeshWidgetDirtyRegion::SetContent(const TSharedRef<SWidget>& InContent)
+{
+	ChildSlot
+	[
+		InContent
+	];
+}
+
+int32 SMeshWidgetDirtyRegion::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	if ( !PaintRegion.IsSet() )
+	{
+		return SCompoundWidget::OnPaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+	}
+
+	bool bOverlapping = false;
+	const FSlateRect PaintCullingRect = MyCullingRect.IntersectionWith(PaintRegion.GetValue(), bOverlapping);
+	const FVector2D PaintCullingSize = PaintCullingRect.GetSize();
+
+	// Culled widgets aren't ticked, but the root of a user widget runs its animations and NativeTick from its
+	// tick, and they decide what changes next
+	if ( !bOverlapping || PaintCullingSize.X <= 0.0f || PaintCullingSize.Y <= 0.0f )
+	{
+		const TSharedRef<SWidget>& Content = ChildSlot.GetWidget();
+		Content->Tick(AllottedGeometry, Args.GetCurrentTime(), Args.GetDeltaTime());
+		return LayerId;
+	}
+
+	OutDrawElements.PushClip(FSlateClippingZone(PaintRegion.GetValue()));
+	const int32 MaxLayerId = SCompoundWidget::OnPaint(Args, AllottedGeometry, PaintCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+	OutDrawElements.PopClip();
+
+	return MaxLayerId;
+}
+
+void FMeshWidgetDirtyRegionTracker::Record(const SWidget& Root)
+{
+	WidgetStates.Reset();
+	RecordWidget(Root);
+}
+
+void FMeshWidgetDirtyRegionTracker::RecordWidget(const SWidget& InWidget)
+{
+	FWidgetState& State = WidgetStates.Add(&InWidget);
+	State.StateHash = MeshWidgetSignature::HashWidgetState(InWidget, 0);
+	State.RenderTransformHash = MeshWidgetSignature::HashRenderTransform(InWidget);
+	State.Visibility = InWidget.GetVisibility();
+	State.DesiredSize = InWidget.GetDesiredSize();
+	State.NumChildren = MeshWidgetDirtyRegion::GetNumChildren(InWidget);
+	State.PaintBox = MeshWidgetDirtyRegion::GetPaintBox(InWidget);
+
+	// Nothing below a hidden or collapsed widget gets painted
+	if ( !State.Visibility.IsVisible() )
+	{
+		return;
+	}
+
+	if ( FChildren* Children = const_cast<SWidget&>(InWidget).GetChildren() )
+	{
+		for ( int32 ChildIndex = 0; ChildIndex < Children->Num(); ++ChildIndex )
+		{
+			RecordWidget(Children->GetChildAt(ChildIndex).Get());
+		}
+	}
+}
+
+bool FMeshWidgetDirtyRegionTracker::Update(const SWidget& Root, FBox2D& OutDirtyBox)
+{
+	OutDirtyBox = FBox2D(ForceInit);
+
+	const FWidgetState* RootState = WidgetStates.Find(&Root);
+	if ( RootState == nullptr )
+	{
+		return false;
+	}
+
+	return UpdateWidget(Root, RootState->PaintBox, OutDirtyBox);
+}
+
+bool FMeshWidgetDirtyRegionTracker::UpdateWidget(const SWidget& InWidget, const FBox2D& ParentPaintBox, FBox2D& OutDirtyBox)
+{
+	FWidgetState* State = WidgetStates.Find(&InWidget);
+	if ( State == nullptr )
+	{
+		return false;
+	}
+
+	// Showing or hiding a widget also changes what the hit test grid of the last full repaint holds
+	const EVisibility Visibility = InWidget.GetVisibility();
+	if ( Visibility != State->Visibility )
+	{
+		return false;
+	}
+
+	if ( !Visibility.IsVisible() )
+	{
+		return true;
+	}
+
+	if ( MeshWidgetSignature::HashRenderTransform(InWidget) != State->RenderTransformHash
+		|| MeshWidgetDirtyRegion::GetNumChildren(InWidget) != State->NumChildren )
+	{
+		return false;
+	}
+
+	// Partial repaints arrange what they paint again, so take where the widget was painted last
+	State->PaintBox = MeshWidgetDirtyRegion::GetPaintBox(InWidget);
+
+	// The parent arranges its children from their desired sizes, so the change stays within the parent
+	const FVector2D DesiredSize = InWidget.GetDesiredSize();
+	if ( DesiredSize != State->DesiredSize )
+	{
+		OutDirtyBox += ParentPaintBox;
+		State->DesiredSize = DesiredSize;
+	}
+
+	const uint32 StateHash = MeshWidgetSignature::HashWidgetState(InWidget, 0);
+	if ( StateHash != State->StateHash || InWidget.IsVolatile() || InWidget.HasKeyboardFocus() || !MeshWidgetSignature::IsPaintHashed(InWidget) )
+	{
+		OutDirtyBox += State->PaintBox;
+		State->StateHash = StateHash;
+	}
+
+	const FBox2D PaintBox = State->PaintBox;
+	if ( FChildren* Children = const_cast<SWidget&>(InWidget).GetChildren() )
+	{
+		for ( int32 ChildIndex = 0; ChildIndex < Children->Num(); ++ChildIndex )
+		{
+			if ( !UpdateWidget(Children->GetChildAt(ChildIndex).Get(), PaintBox, OutDirtyBox) )
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
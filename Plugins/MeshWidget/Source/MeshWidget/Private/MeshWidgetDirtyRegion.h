@@ -0,0 +1,86 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+
+/**
+ * Hosts the content of a mesh widget's window and can limit its paint to a region: the output is scissored to
+ * the region and widgets entirely outside of it are culled, so they are neither painted nor ticked.
+ */
+class SMeshWidgetDirtyRegion : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SMeshWidgetDirtyRegion)
+	{}
+		SLATE_DEFAULT_SLOT(FArguments, Content)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	/** Replaces the hosted content. */
+	void SetContent(const TSharedRef<SWidget>& InContent);
+
+	/** Limits the next paints to a rectangle in paint space, or lifts the limit if unset. */
+	void SetPaintRegion(const TOptional<FSlateRect>& InPaintRegion) { PaintRegion = InPaintRegion; }
+
+	// Begin SWidget
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	// End SWidget
+
+private:
+	TOptional<FSlateRect> PaintRegion;
+};
+
+/**
+ * Finds the part of a widget tree that has to be repainted by diffing the state of every widget against the
+ * last recorded one.  A widget whose state changed dirties the area it was last painted in, one whose desired
+ * size changed dirties its parent, which arranges it.  Changes that can move widgets outside of those areas
+ * (new or removed children, visibility, render transforms) need a full repaint.
+ */
+class FMeshWidgetDirtyRegionTracker
+{
+public:
+	/** Stores the state and painted geometry of every visible widget, after a full repaint. */
+	void Record(const SWidget& Root);
+
+	/**
+	 * Diffs the tree against the recorded state and takes the new state.  Widgets that are volatile, have
+	 * keyboard focus (a blinking caret) or paint something their state hash can't see (brushes, colors) are
+	 * always dirty.
+	 * @param OutDirtyBox (Out) The paint space area that changed, invalid if nothing did
+	 * @return False if the whole tree has to be repainted
+	 */
+	bool Update(const SWidget& Root, FBox2D& OutDirtyBox);
+
+	/** Forgets the recorded state, the next update asks for a full repaint. */
+	void Reset() { WidgetStates.Reset(); }
+
+private:
+	/** What was recorded about one widget */
+	struct FWidgetState
+	{
+		/** Hash of the widget's own state */
+		uint32 StateHash;
+
+		/** Hash of the render transform, which moves the widget outside of where it was painted */
+		uint32 RenderTransformHash;
+
+		EVisibility Visibility;
+
+		FVector2D DesiredSize;
+
+		int32 NumChildren;
+
+		/** Where the widget was painted, in paint space */
+		FBox2D PaintBox;
+	};
+
+	void RecordWidget(const SWidget& InWidget);
+
+	bool UpdateWidget(const SWidget& InWidget, const FBox2D& ParentPaintBox, FBox2D& OutDirtyBox);
+
+	/** Widgets are only compared with themselves, a recycled address shows up as a changed widget */
+	TMap<const SWidget*, FWidgetState> WidgetStates;
+};
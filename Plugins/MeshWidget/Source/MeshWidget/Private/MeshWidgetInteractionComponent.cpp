@@ -2,6 +2,8 @@
 
 
 #include "MeshWidgetInteractionComponent.h"
+#include "InstancedMeshWidgetComponent.h"
+#include "MeshWidgetStats.h"
 #include "UMG/Public/Blueprint/WidgetLayoutLibrary.h"
 #include "Runtime/Engine/Classes/Components/ArrowComponent.h"
 
@@ -9,6 +11,28 @@
 
 #define LOCTEXT_NAMESPACE "WidgetInteraction"
 
+namespace MeshWidgetInteraction
+{
+	/** @return True if the path goes through the same widgets as the weak path did */
+	static bool IsSameWidgetPath(const FWidgetPath& Path, const FWeakWidgetPath& WeakPath)
+	{
+		if ( Path.Widgets.Num() != WeakPath.Widgets.Num() )
+		{
+			return false;
+		}
+
+		for ( int32 WidgetIndex = 0; WidgetIndex < Path.Widgets.Num(); ++WidgetIndex )
+		{
+			if ( WeakPath.Widgets[WidgetIndex].Pin().Get() != &Path.Widgets[WidgetIndex].Widget.Get() )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
 UMeshWidgetInteractionComponent::UMeshWidgetInteractionComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, VirtualUserIndex(0)
@@ -18,6 +42,7 @@ UMeshWidgetInteractionComponent::UMeshWidgetInteractionComponent(const FObjectIn
 	, bEnableHitTesting(true)
 	, bShowDebug(false)
 	, DebugColor(FLinearColor::Red)
+	, HoveredInstanceIndex(INDEX_NONE)
 {
 	PrimaryComponentTick.bCanEverTick = true;
 
@@ -89,6 +114,9 @@ void UMeshWidgetInteractionComponent::SetCustomHitResult(const FHitResult& HitRe
 
 bool UMeshWidgetInteractionComponent::PerformTrace(FHitResult& HitResult)
 {
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetPerformTrace);
+	MESHWIDGET_SCOPED_NAMED_EVENT("MeshWidget PerformTrace", this);
+
 	FCollisionQueryParams Params = FCollisionQueryParams::DefaultQueryParam;
 	Params.bTraceComplex = true;
 	Params.bReturnFaceIndex = true;
@@ -213,9 +241,13 @@ void UMeshWidgetInteractionComponent::SimulatePointerMovement()
 
 	UWidgetComponent* OldHoveredWidget = HoveredWidgetComponent;
 	UMeshWidgetComponent* OldHoveredMeshWidget = HoveredMeshWidgetComponent;
+	UInstancedMeshWidgetComponent* OldHoveredInstancedMeshWidget = HoveredInstancedMeshWidgetComponent;
+	const int32 OldHoveredInstanceIndex = HoveredInstanceIndex;
 	
 	HoveredWidgetComponent = nullptr;
 	HoveredMeshWidgetComponent = nullptr;
+	HoveredInstancedMeshWidgetComponent = nullptr;
+	HoveredInstanceIndex = INDEX_NONE;
 
 	if (bHit)
 	{
@@ -228,9 +260,17 @@ void UMeshWidgetInteractionComponent::SimulatePointerMovement()
 		HoveredMeshWidgetComponent = Cast<UMeshWidgetComponent>(LastHitResult.GetComponent());
 		if ( HoveredMeshWidgetComponent )
 		{
-			LocalHitLocation = HoveredMeshWidgetComponent->GetLocalHitLocation(LastHitResult);
+			LocalHitLocation = HoveredMeshWidgetComponent->LocalToWindowLocation(HoveredMeshWidgetComponent->GetLocalHitLocation(LastHitResult));
 			WidgetPathUnderFinger = FWidgetPath(HoveredMeshWidgetComponent->GetHitWidgetPath(LastHitResult, /*bIgnoreEnabledStatus*/ false));
 		}
+		HoveredInstancedMeshWidgetComponent = Cast<UInstancedMeshWidgetComponent>(LastHitResult.GetComponent());
+		if ( HoveredInstancedMeshWidgetComponent )
+		{
+			// The item of a hit on an instanced mesh is the instance that was hit
+			HoveredInstanceIndex = LastHitResult.Item;
+			LocalHitLocation = HoveredInstancedMeshWidgetComponent->LocalToWindowLocation(HoveredInstanceIndex, HoveredInstancedMeshWidgetComponent->GetLocalHitLocation(LastHitResult));
+			WidgetPathUnderFinger = FWidgetPath(HoveredInstancedMeshWidgetComponent->GetHitWidgetPath(LastHitResult, /*bIgnoreEnabledStatus*/ false));
+		}
 	}
 
 	if ( bShowDebug )
@@ -239,14 +279,14 @@ void UMeshWidgetInteractionComponent::SimulatePointerMovement()
 		{
 			UKismetSystemLibrary::DrawDebugSphere(this, LastHitResult.ImpactPoint, 2.5f, 12, DebugColor, 0, 2);
 		}
-		if ( HoveredMeshWidgetComponent )
+		if ( HoveredMeshWidgetComponent || HoveredInstancedMeshWidgetComponent )
 		{
 			UKismetSystemLibrary::DrawDebugSphere(this, LastHitResult.ImpactPoint, 2.5f, 12, DebugColor, 0, 2);
 		}
 
 		if ( InteractionSource == EWidgetInteractionSource::World || InteractionSource == EWidgetInteractionSource::Custom )
 		{
-			if ( HoveredWidgetComponent || HoveredMeshWidgetComponent )
+			if ( HoveredWidgetComponent || HoveredMeshWidgetComponent || HoveredInstancedMeshWidgetComponent )
 			{
 				UKismetSystemLibrary::DrawDebugLine(this, LastHitResult.TraceStart, LastHitResult.ImpactPoint, DebugColor, 0, 1);
 			}
@@ -267,15 +307,20 @@ void UMeshWidgetInteractionComponent::SimulatePointerMovement()
 		0.0f,
 		ModifierKeys);
 	
+	// Hover state only changes when the pointer enters or leaves widgets
+	const bool bHoveredWidgetsChanged = !MeshWidgetInteraction::IsSameWidgetPath(WidgetPathUnderFinger, LastWigetPath);
+
 	if (WidgetPathUnderFinger.IsValid())
 	{
-		check(HoveredWidgetComponent || HoveredMeshWidgetComponent);
+		check(HoveredWidgetComponent || HoveredMeshWidgetComponent || HoveredInstancedMeshWidgetComponent);
 		LastWigetPath = WidgetPathUnderFinger;
 		
+		SCOPE_CYCLE_COUNTER(STAT_MeshWidgetRoutePointerMoveEvent);
 		FSlateApplication::Get().RoutePointerMoveEvent(WidgetPathUnderFinger, PointerEvent, false);
 	}
 	else
 	{
+		SCOPE_CYCLE_COUNTER(STAT_MeshWidgetRoutePointerMoveEvent);
 		FWidgetPath EmptyWidgetPath;
 		FSlateApplication::Get().RoutePointerMoveEvent(EmptyWidgetPath, PointerEvent, false);
 
@@ -288,7 +333,26 @@ void UMeshWidgetInteractionComponent::SimulatePointerMovement()
 	}
 	if ( HoveredMeshWidgetComponent )
 	{
-		HoveredMeshWidgetComponent->RequestRedraw();
+		HoveredMeshWidgetComponent->MarkHovered();
+
+		// The material draws the cursor, so only changes of the hovered widgets and drags need a redraw
+		if ( HoveredMeshWidgetComponent->UsesMaterialCursor() )
+		{
+			HoveredMeshWidgetComponent->SetMaterialCursorLocation(HoveredMeshWidgetComponent->GetLocalHitLocation(LastHitResult));
+
+			if ( bHoveredWidgetsChanged || PressedKeys.Num() > 0 )
+			{
+				HoveredMeshWidgetComponent->RequestRedraw();
+			}
+		}
+		else
+		{
+			HoveredMeshWidgetComponent->RequestRedraw();
+		}
+	}
+	if ( HoveredInstancedMeshWidgetComponent )
+	{
+		HoveredInstancedMeshWidgetComponent->RequestInstanceRedraw(HoveredInstanceIndex);
 	}
 
 	LastLocalHitLocation = LocalHitLocation;
@@ -329,11 +393,20 @@ void UMeshWidgetInteractionComponent::SimulatePointerMovement()
 	{
 		if ( OldHoveredMeshWidget )
 		{
+			OldHoveredMeshWidget->HideMaterialCursor();
 			OldHoveredMeshWidget->RequestRedraw();
 		}
 
 		OnHoveredMeshWidgetChanged.Broadcast(HoveredMeshWidgetComponent, OldHoveredMeshWidget);
 	}
+	if ( HoveredInstancedMeshWidgetComponent != OldHoveredInstancedMeshWidget || HoveredInstanceIndex != OldHoveredInstanceIndex )
+	{
+		// Draw the instance we left once more so it loses its hover state
+		if ( OldHoveredInstancedMeshWidget )
+		{
+			OldHoveredInstancedMeshWidget->RequestInstanceRedraw(OldHoveredInstanceIndex);
+		}
+	}
 }
 
 void UMeshWidgetInteractionComponent::PressPointerKey(FKey Key)
@@ -362,7 +435,14 @@ void UMeshWidgetInteractionComponent::PressPointerKey(FKey Key)
 		0.0f,
 		ModifierKeys);
 		
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetRoutePointerDownEvent);
 	FReply Reply = FSlateApplication::Get().RoutePointerDownEvent(WidgetPathUnderFinger, PointerEvent);
+
+	// Pointer movement may not redraw the widget, so show the pressed state
+	if ( HoveredMeshWidgetComponent )
+	{
+		HoveredMeshWidgetComponent->RequestRedraw();
+	}
 	
 	// @TODO Something about double click, expose directly, or automatically do it if key press happens within
 	// the double click timeframe?
@@ -395,7 +475,13 @@ void UMeshWidgetInteractionComponent::ReleasePointerKey(FKey Key)
 		0.0f,
 		ModifierKeys);
 		
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetRoutePointerUpEvent);
 	FReply Reply = FSlateApplication::Get().RoutePointerUpEvent(WidgetPathUnderFinger, PointerEvent);
+
+	if ( HoveredMeshWidgetComponent )
+	{
+		HoveredMeshWidgetComponent->RequestRedraw();
+	}
 }
 
 bool UMeshWidgetInteractionComponent::PressKey(FKey Key, bool bRepeat)
@@ -489,6 +575,7 @@ void UMeshWidgetInteractionComponent::ScrollWheel(float ScrollDelta)
 		ScrollDelta,
 		ModifierKeys);
 
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetRouteMouseWheelEvent);
 	FSlateApplication::Get().RouteMouseWheelOrGestureEvent(WidgetPathUnderFinger, MouseWheelEvent, nullptr);
 }
 
@@ -502,6 +589,12 @@ UMeshWidgetComponent* UMeshWidgetInteractionComponent::GetHoveredMeshWidgetCompo
 	return HoveredMeshWidgetComponent;
 }
 
+UInstancedMeshWidgetComponent* UMeshWidgetInteractionComponent::GetHoveredInstancedMeshWidgetComponent(int32& OutInstanceIndex) const
+{
+	OutInstanceIndex = HoveredInstanceIndex;
+	return HoveredInstancedMeshWidgetComponent;
+}
+
 bool UMeshWidgetInteractionComponent::IsOverInteractableWidget() const
 {
 	return bIsHoveredWidgetInteractable;
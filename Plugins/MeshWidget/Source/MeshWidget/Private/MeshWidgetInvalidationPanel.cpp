@@ -0,0 +1,18 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "MeshWidgetInvalidationPanel.h"
+
+int32 SMeshWidgetInvalidationPanel::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	// Without caching, or when the root was invalidated, the panel paints its content like any other widget
+	if ( !GetCanCache() || NeedsSlowPath() )
+	{
+		NumCacheMisses++;
+	}
+	else
+	{
+		NumCacheHits++;
+	}
+
+	return SInvalidationPanel::OnPaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+}
@@ -0,0 +1,38 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SInvalidationPanel.h"
+
+/**
+ * Retains the draw elements of the content of a mesh widget's window between draws.  Draws take the fast
+ * path, which replays the cached elements and only repaints the widgets that were invalidated, until
+ * something invalidates the layout of the whole panel and it has to take the slow path and repaint everything.
+ * Counts both, so the cache can be checked per component.
+ */
+class SMeshWidgetInvalidationPanel : public SInvalidationPanel
+{
+public:
+	/** @return Number of paints that replayed the cached draw elements */
+	int32 GetNumCacheHits() const { return NumCacheHits; }
+
+	/** @return Number of paints that had to repaint the whole content */
+	int32 GetNumCacheMisses() const { return NumCacheMisses; }
+
+	/** Sets both counters back to 0. */
+	void ResetCacheCounters()
+	{
+		NumCacheHits = 0;
+		NumCacheMisses = 0;
+	}
+
+	// Begin SWidget
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	// End SWidget
+
+private:
+	mutable int32 NumCacheHits = 0;
+
+	mutable int32 NumCacheMisses = 0;
+};
@@ -0,0 +1,199 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "MeshWidgetRenderTargetPool.h"
+
+#include "Engine/TextureRenderTarget2D.h"
+#include "HAL/IConsoleManager.h"
+
+
+static TAutoConsoleVariable<float> CVarMeshWidgetPoolMaxFreeMB(
+	TEXT("r.MeshWidget.RenderTargetPool.MaxFreeMB"),
+	32.0f,
+	TEXT("Memory in megabytes that unused mesh widget render targets may keep in the pool before the oldest are destroyed."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMeshWidgetPoolMaxIdleTime(
+	TEXT("r.MeshWidget.RenderTargetPool.MaxIdleTime"),
+	10.0f,
+	TEXT("Seconds an unused mesh widget render target stays in the pool before it is destroyed.  0 keeps them until the pool is over budget."),
+	ECVF_Default);
+
+namespace MeshWidgetRenderTargetPool
+{
+	static int64 GetMemorySize(const UTextureRenderTarget2D* RenderTarget)
+	{
+		return RenderTarget ? RenderTarget->CalcTextureMemorySizeEnum(TMC_AllMips) : 0;
+	}
+
+	static float ToMB(int64 Bytes)
+	{
+		return Bytes / (1024.0f * 1024.0f);
+	}
+}
+
+FMeshWidgetRenderTargetDesc::FMeshWidgetRenderTargetDesc(FIntPoint InSize, EPixelFormat InFormat, bool bInForceLinearGamma, const FLinearColor& InClearColor, bool bInMips, TextureFilter InMipsFilter)
+	: Size(InSize)
+	, Format(InFormat)
+	, bForceLinearGamma(bInForceLinearGamma)
+	, ClearColor(InClearColor)
+	, bMips(bInMips)
+	, MipsFilter(bInMips ? InMipsFilter : TF_Default)
+{
+}
+
+FMeshWidgetRenderTargetDesc::FMeshWidgetRenderTargetDesc(const UTextureRenderTarget2D* RenderTarget)
+	: Size(RenderTarget->SizeX, RenderTarget->SizeY)
+	, Format(RenderTarget->OverrideFormat)
+	, bForceLinearGamma(RenderTarget->bForceLinearGamma)
+	, ClearColor(RenderTarget->ClearColor)
+	, bMips(RenderTarget->bAutoGenerateMips)
+	, MipsFilter(RenderTarget->bAutoGenerateMips ? RenderTarget->MipsSamplerFilter.GetValue() : TF_Default)
+{
+}
+
+bool FMeshWidgetRenderTargetDesc::operator==(const FMeshWidgetRenderTargetDesc& Other) const
+{
+	return Size == Other.Size && Format == Other.Format && bForceLinearGamma == Other.bForceLinearGamma && ClearColor == Other.ClearColor
+		&& bMips == Other.bMips && MipsFilter == Other.MipsFilter;
+}
+
+UTextureRenderTarget2D* UMeshWidgetRenderTargetPool::Acquire(const FMeshWidgetRenderTargetDesc& Desc)
+{
+	// Most recently released first, it's the least likely to be trimmed soon anyway
+	for ( int32 FreeIndex = FreeRenderTargets.Num() - 1; FreeIndex >= 0; --FreeIndex )
+	{
+		UTextureRenderTarget2D* RenderTarget = FreeRenderTargets[FreeIndex].RenderTarget;
+		if ( RenderTarget && FMeshWidgetRenderTargetDesc(RenderTarget) == Desc )
+		{
+			FreeRenderTargets.RemoveAt(FreeIndex);
+			InUseRenderTargets.Add(RenderTarget);
+			NumHits++;
+			return RenderTarget;
+		}
+	}
+
+	UTextureRenderTarget2D* RenderTarget = NewObject<UTextureRenderTarget2D>(this);
+	RenderTarget->ClearColor = Desc.ClearColor;
+	RenderTarget->bAutoGenerateMips = Desc.bMips;
+	RenderTarget->MipsSamplerFilter = Desc.MipsFilter;
+	RenderTarget->InitCustomFormat(Desc.Size.X, Desc.Size.Y, Desc.Format, Desc.bForceLinearGamma);
+
+	InUseRenderTargets.Add(RenderTarget);
+	NumMisses++;
+	return RenderTarget;
+}
+
+void UMeshWidgetRenderTargetPool::Release(UTextureRenderTarget2D* RenderTarget)
+{
+	if ( RenderTarget && InUseRenderTargets.Remove(RenderTarget) > 0 )
+	{
+		FMeshWidgetPooledRenderTarget& Pooled = FreeRenderTargets.AddDefaulted_GetRef();
+		Pooled.RenderTarget = RenderTarget;
+		Pooled.ReleaseTime = FPlatformTime::Seconds();
+	}
+}
+
+bool UMeshWidgetRenderTargetPool::Reclaim(UTextureRenderTarget2D* RenderTarget)
+{
+	const int32 FreeIndex = FreeRenderTargets.IndexOfByPredicate([RenderTarget](const FMeshWidgetPooledRenderTarget& Pooled) { return Pooled.RenderTarget == RenderTarget; });
+	if ( FreeIndex == INDEX_NONE )
+	{
+		return false;
+	}
+
+	FreeRenderTargets.RemoveAt(FreeIndex);
+	InUseRenderTargets.Add(RenderTarget);
+	return true;
+}
+
+void UMeshWidgetRenderTargetPool::Trim()
+{
+	using namespace MeshWidgetRenderTargetPool;
+
+	const double MaxIdleTime = CVarMeshWidgetPoolMaxIdleTime.GetValueOnGameThread();
+	const double Now = FPlatformTime::Seconds();
+
+	if ( MaxIdleTime > 0.0 )
+	{
+		for ( int32 FreeIndex = FreeRenderTargets.Num() - 1; FreeIndex >= 0; --FreeIndex )
+		{
+			if ( Now - FreeRenderTargets[FreeIndex].ReleaseTime > MaxIdleTime )
+			{
+				DestroyFreeRenderTarget(FreeIndex);
+			}
+		}
+	}
+
+	TrimToSize((int64)(CVarMeshWidgetPoolMaxFreeMB.GetValueOnGameThread() * 1024.0f * 1024.0f));
+}
+
+void UMeshWidgetRenderTargetPool::TrimToSize(int64 MaxFreeBytes)
+{
+	using namespace MeshWidgetRenderTargetPool;
+
+	int64 FreeBytes = GetFreeMemorySize();
+	while ( FreeBytes > MaxFreeBytes && FreeRenderTargets.Num() > 0 )
+	{
+		FreeBytes -= GetMemorySize(FreeRenderTargets[0].RenderTarget);
+		DestroyFreeRenderTarget(0);
+	}
+}
+
+int64 UMeshWidgetRenderTargetPool::GetInUseMemorySize() const
+{
+	int64 InUseBytes = 0;
+	for ( const UTextureRenderTarget2D* RenderTarget : InUseRenderTargets )
+	{
+		InUseBytes += MeshWidgetRenderTargetPool::GetMemorySize(RenderTarget);
+	}
+
+	return InUseBytes;
+}
+
+int64 UMeshWidgetRenderTargetPool::GetFreeMemorySize() const
+{
+	int64 FreeBytes = 0;
+	for ( const FMeshWidgetPooledRenderTarget& Pooled : FreeRenderTargets )
+	{
+		FreeBytes += MeshWidgetRenderTargetPool::GetMemorySize(Pooled.RenderTarget);
+	}
+
+	return FreeBytes;
+}
+
+void UMeshWidgetRenderTargetPool::Empty()
+{
+	while ( FreeRenderTargets.Num() > 0 )
+	{
+		DestroyFreeRenderTarget(FreeRenderTargets.Num() - 1);
+	}
+}
+
+FMeshWidgetRenderTargetPoolStats UMeshWidgetRenderTargetPool::GetStats() const
+{
+	using namespace MeshWidgetRenderTargetPool;
+
+	FMeshWidgetRenderTargetPoolStats Stats;
+	Stats.NumInUse = InUseRenderTargets.Num();
+	Stats.NumFree = FreeRenderTargets.Num();
+	Stats.NumHits = NumHits;
+	Stats.NumMisses = NumMisses;
+	Stats.NumTrimmed = NumTrimmed;
+
+	Stats.InUseMemoryMB = ToMB(GetInUseMemorySize());
+	Stats.FreeMemoryMB = ToMB(GetFreeMemorySize());
+
+	return Stats;
+}
+
+void UMeshWidgetRenderTargetPool::DestroyFreeRenderTarget(int32 FreeIndex)
+{
+	if ( UTextureRenderTarget2D* RenderTarget = FreeRenderTargets[FreeIndex].RenderTarget )
+	{
+		// Free the GPU memory now rather than whenever the object is collected
+		RenderTarget->ReleaseResource();
+	}
+
+	FreeRenderTargets.RemoveAt(FreeIndex);
+	NumTrimmed++;
+}
@@ -0,0 +1,54 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "MeshWidgetRendering.h"
+
+#include "ClearQuad.h"
+#include "GenerateMips.h"
+#include "RHICommandList.h"
+#include "RenderingThread.h"
+#include "TextureResource.h"
+#include "Engine/TextureRenderTarget2D.h"
+
+void MeshWidgetRendering::ClearRenderTargetRegion(UTextureRenderTarget2D* RenderTarget, const FIntRect& Region, const FLinearColor& ClearColor)
+{
+	FTextureRenderTargetResource* RenderTargetResource = RenderTarget ? RenderTarget->GameThread_GetRenderTargetResource() : nullptr;
+	if ( RenderTargetResource == nullptr || Region.Area() <= 0 )
+	{
+		return;
+	}
+
+	ENQUEUE_RENDER_COMMAND(ClearMeshWidgetRegion)(
+		[RenderTargetResource, Region, ClearColor](FRHICommandListImmediate& RHICmdList)
+		{
+			FRHIRenderPassInfo RPInfo(RenderTargetResource->GetRenderTargetTexture(), ERenderTargetActions::Load_Store);
+			RHICmdList.BeginRenderPass(RPInfo, TEXT("ClearMeshWidgetRegion"));
+			RHICmdList.SetViewport(Region.Min.X, Region.Min.Y, 0.0f, Region.Max.X, Region.Max.Y, 1.0f);
+			DrawClearQuad(RHICmdList, ClearColor);
+			RHICmdList.EndRenderPass();
+		});
+}
+
+void MeshWidgetRendering::GenerateMips(UTextureRenderTarget2D* RenderTarget, TextureFilter Filter)
+{
+	FTextureRenderTargetResource* RenderTargetResource = RenderTarget ? RenderTarget->GameThread_GetRenderTargetResource() : nullptr;
+	if ( RenderTargetResource == nullptr || !RenderTarget->bAutoGenerateMips )
+	{
+		return;
+	}
+
+	const ESamplerFilter SamplerFilter = Filter == TF_Nearest ? SF_Point : ( Filter == TF_Bilinear ? SF_Bilinear : SF_Trilinear );
+
+	ENQUEUE_RENDER_COMMAND(GenerateMeshWidgetMips)(
+		[RenderTargetResource, SamplerFilter](FRHICommandListImmediate& RHICmdList)
+		{
+			FRHITexture* Texture = RenderTargetResource->GetRenderTargetTexture();
+			if ( Texture && Texture->GetNumMips() > 1 )
+			{
+				FGenerateMipsParams Params;
+				Params.Filter = SamplerFilter;
+				Params.AddressU = AM_Clamp;
+				Params.AddressV = AM_Clamp;
+				FGenerateMips::Execute(RHICmdList, Texture, Params);
+			}
+		});
+}
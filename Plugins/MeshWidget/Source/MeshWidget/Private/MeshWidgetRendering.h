@@ -0,0 +1,18 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Texture.h"
+
+class UTextureRenderTarget2D;
+
+/** Render thread helpers shared by the mesh widget components. */
+namespace MeshWidgetRendering
+{
+	/** Enqueues a clear of one region of a render target, leaving the rest of it untouched. */
+	void ClearRenderTargetRegion(UTextureRenderTarget2D* RenderTarget, const FIntRect& Region, const FLinearColor& ClearColor);
+
+	/** Enqueues the generation of the mip chain of a render target created with bAutoGenerateMips from its top mip. */
+	void GenerateMips(UTextureRenderTarget2D* RenderTarget, TextureFilter Filter);
+}
@@ -0,0 +1,87 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "MeshWidgetScalability.h"
+
+#include "Scalability.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+
+
+static TAutoConsoleVariable<int32> CVarMeshWidgetQuality(
+	TEXT("sg.MeshWidgetQuality"),
+	-1,
+	TEXT("Scalability quality of mesh widgets, applies the [MeshWidgetQuality@N] section of the scalability ini.\n")
+	TEXT("-1: follow sg.EffectsQuality (default)\n")
+	TEXT("0: low, 1: medium, 2: high, 3: epic, 4: cinematic"),
+	ECVF_ScalabilityGroup);
+
+static TAutoConsoleVariable<float> CVarMeshWidgetResolutionScale(
+	TEXT("r.MeshWidget.ResolutionScale"),
+	1.0f,
+	TEXT("Scale applied to the resolution of every mesh widget render target, on top of the resolution LOD.\n")
+	TEXT("Layout and hit testing still happen at the draw size. Clamped to [0.1, 2]."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarMeshWidgetMaxRedrawRate(
+	TEXT("r.MeshWidget.MaxRedrawRate"),
+	0.0f,
+	TEXT("The most times per second a mesh widget is redrawn, whatever its redraw time or adaptive rate asks for.\n")
+	TEXT("0 means no limit."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<int32> CVarMeshWidgetMaxLiveWidgets(
+	TEXT("r.MeshWidget.MaxLiveWidgets"),
+	0,
+	TEXT("The most mesh widgets per world that keep a live widget. The least significant others are frozen into their\n")
+	TEXT("texture, keeping their user widget but not its Slate resources, until they become significant enough again.\n")
+	TEXT("Only a few widgets freeze or thaw per frame. 0 means no limit."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<int32> CVarMeshWidgetMaxRedrawsPerFrame(
+	TEXT("r.MeshWidget.MaxRedrawsPerFrame"),
+	0,
+	TEXT("The most mesh widgets drawn per frame and world, on top of r.MeshWidget.FrameBudgetMs. Also caps the\n")
+	TEXT("instances drawn per frame by each instanced mesh widget. 0 means no limit."),
+	ECVF_Scalability);
+
+namespace MeshWidgetScalability
+{
+	/** The quality level whose ini section was applied last */
+	static int32 AppliedQualityLevel = INDEX_NONE;
+}
+
+void MeshWidgetScalability::UpdateQualityLevel()
+{
+	int32 QualityLevel = CVarMeshWidgetQuality.GetValueOnGameThread();
+	if ( QualityLevel < 0 )
+	{
+		QualityLevel = Scalability::GetQualityLevels().EffectsQuality;
+	}
+	QualityLevel = FMath::Clamp(QualityLevel, 0, 4);
+
+	if ( QualityLevel != AppliedQualityLevel )
+	{
+		AppliedQualityLevel = QualityLevel;
+		ApplyCVarSettingsGroupFromIni(TEXT("MeshWidgetQuality"), QualityLevel, *GScalabilityIni, ECVF_SetByScalability);
+	}
+}
+
+float MeshWidgetScalability::GetResolutionScale()
+{
+	return FMath::Clamp(CVarMeshWidgetResolutionScale.GetValueOnGameThread(), 0.1f, 2.0f);
+}
+
+float MeshWidgetScalability::GetMaxRedrawRate()
+{
+	return FMath::Max(CVarMeshWidgetMaxRedrawRate.GetValueOnGameThread(), 0.0f);
+}
+
+int32 MeshWidgetScalability::GetMaxLiveWidgets()
+{
+	return FMath::Max(CVarMeshWidgetMaxLiveWidgets.GetValueOnGameThread(), 0);
+}
+
+int32 MeshWidgetScalability::GetMaxRedrawsPerFrame()
+{
+	return FMath::Max(CVarMeshWidgetMaxRedrawsPerFrame.GetValueOnGameThread(), 0);
+}
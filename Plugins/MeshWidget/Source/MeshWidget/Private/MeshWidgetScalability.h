@@ -0,0 +1,29 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Global limits on the cost of mesh widgets, set from the r.MeshWidget.* console variables.  The sg.MeshWidgetQuality
+ * scalability group sets them from the [MeshWidgetQuality@N] sections of the scalability ini, and follows
+ * sg.EffectsQuality unless it is set itself.  The plugin's config adds default sections to the scalability ini
+ * when the module starts, unless the project has its own.
+ */
+namespace MeshWidgetScalability
+{
+	/** Applies the scalability ini section of the mesh widget quality level, if the level changed. */
+	void UpdateQualityLevel();
+
+	/** @return The scale applied to the resolution of every mesh widget render target */
+	float GetResolutionScale();
+
+	/** @return The most times per second a mesh widget is redrawn, 0 for no limit */
+	float GetMaxRedrawRate();
+
+	/** @return The most mesh widgets that keep a live widget, the least significant others are frozen; 0 for no limit */
+	int32 GetMaxLiveWidgets();
+
+	/** @return The most mesh widgets drawn per frame, 0 for no limit */
+	int32 GetMaxRedrawsPerFrame();
+}
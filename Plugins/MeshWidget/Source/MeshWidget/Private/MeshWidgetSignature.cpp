@@ -0,0 +1,136 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "MeshWidgetSignature.h"
+
+#include "Widgets/SWidget.h"
+#include "Widgets/Text/STextBlock.h"
+
+void FMeshWidgetTextCache::BeginPass()
+{
+	Swap(Texts, PreviousTexts);
+	Texts.Reset();
+}
+
+uint32 FMeshWidgetTextCache::GetTextVersion(const STextBlock& TextBlock)
+{
+	const FText Text = TextBlock.GetText();
+
+	FCachedText CachedText;
+	if ( const FCachedText* PreviousText = PreviousTexts.Find(&TextBlock) )
+	{
+		CachedText = *PreviousText;
+	}
+
+	// Only text that isn't the same instance has its string compared, and formatted text seldom is
+	if ( !CachedText.Text.IdenticalTo(Text) )
+	{
+		if ( !CachedText.Text.ToString().Equals(Text.ToString(), ESearchCase::CaseSensitive) )
+		{
+			CachedText.Version++;
+		}
+		CachedText.Text = Text;
+	}
+
+	Texts.Add(&TextBlock, CachedText);
+	return CachedText.Version;
+}
+
+uint32 MeshWidgetSignature::HashRenderTransform(const SWidget& InWidget)
+{
+	const TOptional<FSlateRenderTransform> RenderTransform = InWidget.GetRenderTransform();
+	if ( !RenderTransform.IsSet() )
+	{
+		return 0;
+	}
+
+	float A, B, C, D;
+	RenderTransform->GetMatrix().GetMatrix(A, B, C, D);
+	return HashCombine(GetTypeHash(RenderTransform->GetTranslation()), HashCombine(HashCombine(GetTypeHash(A), GetTypeHash(B)), HashCombine(GetTypeHash(C), GetTypeHash(D))));
+}
+
+uint32 MeshWidgetSignature::HashWidgetState(const SWidget& InWidget, uint32 Hash, FMeshWidgetTextCache* TextCache)
+{
+	static const FName TextBlockType(TEXT("STextBlock"));
+
+	const EVisibility Visibility = InWidget.GetVisibility();
+
+	uint32 StateFlags = 0;
+	StateFlags |= Visibility.IsVisible() ? 1 << 0 : 0;
+	StateFlags |= Visibility == EVisibility::Collapsed ? 1 << 1 : 0;
+	StateFlags |= InWidget.IsEnabled() ? 1 << 2 : 0;
+	StateFlags |= InWidget.IsHovered() ? 1 << 3 : 0;
+	StateFlags |= InWidget.HasKeyboardFocus() ? 1 << 4 : 0;
+
+	Hash = HashCombine(Hash, GetTypeHash(InWidget.GetType()));
+	Hash = HashCombine(Hash, StateFlags);
+
+	// Nothing of a hidden or collapsed widget gets painted
+	if ( !Visibility.IsVisible() )
+	{
+		return Hash;
+	}
+
+	Hash = HashCombine(Hash, GetTypeHash(InWidget.GetRenderOpacity()));
+	Hash = HashCombine(Hash, HashRenderTransform(InWidget));
+
+	// Evaluates the text binding, which catches text changes that keep the same size
+	if ( InWidget.GetType() == TextBlockType )
+	{
+		const STextBlock& TextBlock = static_cast<const STextBlock&>(InWidget);
+		Hash = HashCombine(Hash, TextCache ? TextCache->GetTextVersion(TextBlock) : GetTypeHash(TextBlock.GetText().ToString()));
+	}
+
+	return Hash;
+}
+
+bool MeshWidgetSignature::IsPaintHashed(const SWidget& InWidget)
+{
+	static const TSet<FName> PaintHashedTypes =
+	{
+		TEXT("STextBlock"),
+		TEXT("SWindow"),
+		TEXT("SVirtualWindow"),
+		TEXT("SMeshWidgetDirtyRegion"),
+		TEXT("SInvalidationPanel"),
+		TEXT("SObjectWidget"),
+		TEXT("SWeakWidget"),
+		TEXT("SNullWidgetContent"),
+		TEXT("SDPIScaler"),
+		TEXT("SSafeZone"),
+		TEXT("SOverlay"),
+		TEXT("SVerticalBox"),
+		TEXT("SHorizontalBox"),
+		TEXT("SBox"),
+		TEXT("SScaleBox"),
+		TEXT("SCanvas"),
+		TEXT("SConstraintCanvas"),
+		TEXT("SGridPanel"),
+		TEXT("SUniformGridPanel"),
+		TEXT("SWrapBox"),
+		TEXT("SSpacer"),
+	};
+
+	return PaintHashedTypes.Contains(InWidget.GetType());
+}
+
+uint32 MeshWidgetSignature::HashWidget(const SWidget& InWidget, uint32 Hash, FMeshWidgetTextCache* TextCache)
+{
+	Hash = HashWidgetState(InWidget, Hash, TextCache);
+
+	// Nothing below a hidden or collapsed widget gets painted
+	if ( !InWidget.GetVisibility().IsVisible() )
+	{
+		return Hash;
+	}
+
+	if ( FChildren* Children = const_cast<SWidget&>(InWidget).GetChildren() )
+	{
+		Hash = HashCombine(Hash, Children->Num());
+		for ( int32 ChildIndex = 0; ChildIndex < Children->Num(); ++ChildIndex )
+		{
+			Hash = HashWidget(Children->GetChildAt(ChildIndex).Get(), Hash, TextCache);
+		}
+	}
+
+	return Hash;
+}
@@ -0,0 +1,57 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class SWidget;
+class STextBlock;
+
+/**
+ * The text last shown by every text block of a widget tree.  Text bindings usually hand back the same text every
+ * time, which FText::IdenticalTo recognizes without touching the string, so unchanged text costs no string hashing.
+ */
+class FMeshWidgetTextCache
+{
+public:
+	/** Starts a walk of the tree, the blocks that aren't visited again are forgotten at the next one. */
+	void BeginPass();
+
+	/** @return A number that changes whenever the text shown by the block changes */
+	uint32 GetTextVersion(const STextBlock& TextBlock);
+
+private:
+	struct FCachedText
+	{
+		FText Text;
+		uint32 Version = 0;
+	};
+
+	/** The texts visited by the current walk */
+	TMap<const STextBlock*, FCachedText> Texts;
+
+	/** The texts visited by the previous walk */
+	TMap<const STextBlock*, FCachedText> PreviousTexts;
+};
+
+/** Hashes of the state of a hosted widget tree that decides how it is painted. */
+namespace MeshWidgetSignature
+{
+	/** @return The hash of the render transform of a widget, 0 if it has none */
+	uint32 HashRenderTransform(const SWidget& InWidget);
+
+	/**
+	 * @param TextCache If set, text is hashed by the version the cache gives it rather than by its string
+	 * @return Hash combined with the state of the widget itself: type, visibility, hover, focus, opacity, render transform and text
+	 */
+	uint32 HashWidgetState(const SWidget& InWidget, uint32 Hash, FMeshWidgetTextCache* TextCache = nullptr);
+
+	/**
+	 * @return True if HashWidgetState sees everything the widget paints itself: panels that only arrange their
+	 * children and text blocks.  Images, borders, progress bars and unknown widgets paint brushes and colors it can't read.
+	 */
+	bool IsPaintHashed(const SWidget& InWidget);
+
+	/** @return Hash combined with the state of the widget and everything visible below it */
+	uint32 HashWidget(const SWidget& InWidget, uint32 Hash, FMeshWidgetTextCache* TextCache = nullptr);
+}
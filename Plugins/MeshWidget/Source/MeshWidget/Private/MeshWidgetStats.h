@@ -0,0 +1,43 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("MeshWidget"), STATGROUP_MeshWidget, STATCAT_Advanced);
+
+// Drawing
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Subsystem Tick"), STAT_MeshWidgetSubsystemTick, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Draw Widget"), STAT_MeshWidgetDrawWidget, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Widget"), STAT_MeshWidgetUpdateWidget, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Slate Prepass"), STAT_MeshWidgetSlatePrepass, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Draw Window"), STAT_MeshWidgetDrawWindow, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Render Target"), STAT_MeshWidgetUpdateRenderTarget, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Material Parameters"), STAT_MeshWidgetUpdateMaterialParameters, STATGROUP_MeshWidget, );
+
+// Interaction
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Perform Trace"), STAT_MeshWidgetPerformTrace, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Get Local Hit Location"), STAT_MeshWidgetGetLocalHitLocation, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Get Bubble Path"), STAT_MeshWidgetGetBubblePath, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Route Pointer Move Event"), STAT_MeshWidgetRoutePointerMoveEvent, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Route Pointer Down Event"), STAT_MeshWidgetRoutePointerDownEvent, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Route Pointer Up Event"), STAT_MeshWidgetRoutePointerUpEvent, STATGROUP_MeshWidget, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Route Mouse Wheel Event"), STAT_MeshWidgetRouteMouseWheelEvent, STATGROUP_MeshWidget, );
+
+// Counters, reset every frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Redraws"), STAT_MeshWidgetNumRedraws, STATGROUP_MeshWidget, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Partial Redraws"), STAT_MeshWidgetNumPartialRedraws, STATGROUP_MeshWidget, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pending Redraws"), STAT_MeshWidgetNumPendingRedraws, STATGROUP_MeshWidget, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Material Parameters Set"), STAT_MeshWidgetNumMaterialParametersSet, STATGROUP_MeshWidget, );
+
+/**
+ * Opens a named event for the rest of the scope carrying the name of the object, so captured traces show which
+ * widget the time went to.  The name is only formatted while named events are being emitted.
+ */
+#if ENABLE_STATNAMEDEVENTS
+#define MESHWIDGET_SCOPED_NAMED_EVENT(Label, Object) \
+	FScopedNamedEventConditional ANONYMOUS_VARIABLE(MeshWidgetNamedEvent_)(FColor::Turquoise, GCycleStatsShouldEmitNamedEvents > 0 ? *FString::Printf(TEXT("%s %s"), TEXT(Label), *GetNameSafe(Object)) : TEXT(""), GCycleStatsShouldEmitNamedEvents > 0)
+#else
+#define MESHWIDGET_SCOPED_NAMED_EVENT(Label, Object)
+#endif
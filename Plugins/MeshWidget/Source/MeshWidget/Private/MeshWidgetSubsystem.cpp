@@ -0,0 +1,837 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "MeshWidgetSubsystem.h"
+
+#include "MeshWidgetComponent.h"
+#include "InstancedMeshWidgetComponent.h"
+#include "MeshWidgetScalability.h"
+#include "MeshWidgetStats.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Engine/World.h"
+#include "SceneView.h"
+#include "SceneManagement.h"
+#include "HAL/IConsoleManager.h"
+
+
+static TAutoConsoleVariable<float> CVarMeshWidgetFrameBudgetMs(
+	TEXT("r.MeshWidget.FrameBudgetMs"),
+	2.0f,
+	TEXT("Game thread time in milliseconds that mesh widgets may spend redrawing each frame.\n")
+	TEXT("At least one widget is always drawn per frame, widgets that don't fit wait for the next frame.\n")
+	TEXT("0 means no limit."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMeshWidgetDeferRenderTargetUpdates(
+	TEXT("r.MeshWidget.DeferRenderTargetUpdates"),
+	1,
+	TEXT("1: Scheduled mesh widget draws hand their render target updates to the Slate renderer, which runs them all in one render thread pass when it draws the windows.\n")
+	TEXT("0: Every draw enqueues its own render command."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMeshWidgetRenderTargetBudgetMB(
+	TEXT("r.MeshWidget.RenderTargetBudgetMB"),
+	0.0f,
+	TEXT("Megabytes of render target memory that the mesh widgets of a world may use, counting pooled render targets and atlas pages.\n")
+	TEXT("Over the budget, the pool is emptied and then widgets that aren't in or near a view release their render target until it fits.\n")
+	TEXT("0 means no budget."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMeshWidgetRenderTargetEvictionPolicy(
+	TEXT("r.MeshWidget.RenderTargetEvictionPolicy"),
+	0,
+	TEXT("Which mesh widgets release their render target first when over r.MeshWidget.RenderTargetBudgetMB.\n")
+	TEXT("0: The widgets rendered on screen least recently\n")
+	TEXT("1: The least significant widgets"),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice CmdMeshWidgetDump(
+	TEXT("meshwidget.dump"),
+	TEXT("Lists the mesh widgets of the world with their owner, class, draw size, memory, redraw count and last draw time, most expensive first, and the instanced mesh widgets with their atlas."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		UMeshWidgetSubsystem* Subsystem = World ? World->GetSubsystem<UMeshWidgetSubsystem>() : nullptr;
+		if ( Subsystem )
+		{
+			Subsystem->DumpWidgets(Ar);
+		}
+	}));
+
+namespace MeshWidgetSubsystem
+{
+	/** Priority gained by a widget covering the whole screen */
+	const float CoverageWeight = 10.0f;
+
+	/** Priority gained while a widget is hovered by an interaction component */
+	const float HoveredBonus = 5.0f;
+
+	/** Priority gained per second since the widget was last drawn */
+	const float WaitingWeight = 1.0f;
+
+	/** Size of a new atlas page, unless the first widget needs more */
+	const int32 InitialAtlasPageSize = 1024;
+
+	/** Atlas pages grow up to this size before a new page is started */
+	const int32 MaxAtlasPageSize = 4096;
+
+	/** Screen size at which a widget is fully significant by size */
+	const float SignificantScreenSize = 0.5f;
+
+	/** Distance in world units under which a widget is fully significant by distance */
+	const float SignificantDistance = 200.0f;
+
+	/** Cosine of the angle from the view direction inside which a widget is fully significant by angle (about 10 degrees) */
+	const float FocusConeCos = 0.985f;
+
+	/** Cosine of the angle from the view direction past which a widget is peripheral (60 degrees) */
+	const float PeripheralConeCos = 0.5f;
+
+	/** Screen size from which a widget in the focus cone counts as looked at, rather than looked past */
+	const float FocusScreenSize = 0.05f;
+
+	/** Weights of the factors of a widget outside the focus cone, they add up to 1 */
+	const float SizeSignificanceWeight = 0.6f;
+	const float DistanceSignificanceWeight = 0.4f;
+
+	/** The most significance a widget outside the focus cone gets from its size and distance */
+	const float PeripheralSignificanceScale = 0.25f;
+
+	/** Scale of the projection of the pre-draw frustum, 0.8 widens the field of view by about a quarter */
+	const float PreDrawFrustumScale = 0.8f;
+
+	/** Significance added while the widget plays an animation */
+	const float AnimationSignificanceBonus = 0.25f;
+
+	/** Significance a live widget keeps over frozen ones under the live widget limit, so they don't trade places every frame */
+	const float LiveWidgetSignificanceBonus = 0.1f;
+
+	/** Widgets frozen or thawed for the live widget limit per frame, the others wait for the next frames */
+	const int32 MaxLiveWidgetTransitionsPerFrame = 4;
+
+	static EMeshWidgetEvictionPolicy GetEvictionPolicy()
+	{
+		return CVarMeshWidgetRenderTargetEvictionPolicy.GetValueOnGameThread() == 1 ? EMeshWidgetEvictionPolicy::LeastSignificant : EMeshWidgetEvictionPolicy::LeastRecentlySeen;
+	}
+
+	/** A widget or an instance picked to be drawn this frame */
+	struct FScheduledRedraw
+	{
+		float Priority;
+		UMeshWidgetComponent* Component;
+		UInstancedMeshWidgetComponent* InstancedComponent;
+		int32 InstanceIndex;
+	};
+
+	static float ToKB(int64 Bytes)
+	{
+		return Bytes / 1024.0f;
+	}
+
+	static int64 GetRenderTargetBudget()
+	{
+		return (int64)(FMath::Max(CVarMeshWidgetRenderTargetBudgetMB.GetValueOnGameThread(), 0.0f) * 1024.0f * 1024.0f);
+	}
+}
+
+void UMeshWidgetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	RenderTargetPool = NewObject<UMeshWidgetRenderTargetPool>(this);
+
+	WorldPreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UMeshWidgetSubsystem::OnWorldPreActorTick);
+
+	NumRedrawsLastFrame = 0;
+	NumRenderTargetEvictions = 0;
+	NumRenderTargetReacquisitions = 0;
+}
+
+void UMeshWidgetSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(WorldPreActorTickHandle);
+
+	Components.Reset();
+	PendingRedraws.Reset();
+	InstancedComponents.Reset();
+	PendingInstanceRedraws.Reset();
+	AtlasPages.Reset();
+	Views.Reset();
+
+	if ( RenderTargetPool )
+	{
+		RenderTargetPool->Empty();
+	}
+
+	Super::Deinitialize();
+}
+
+bool UMeshWidgetSubsystem::IsTickable() const
+{
+	return !IsTemplate();
+}
+
+TStatId UMeshWidgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMeshWidgetSubsystem, STATGROUP_Tickables);
+}
+
+void UMeshWidgetSubsystem::RegisterComponent(UMeshWidgetComponent* Component)
+{
+	Components.AddUnique(Component);
+}
+
+void UMeshWidgetSubsystem::UnregisterComponent(UMeshWidgetComponent* Component)
+{
+	Components.RemoveSingleSwap(Component);
+	PendingRedraws.Remove(Component);
+}
+
+void UMeshWidgetSubsystem::RequestRedrawSlot(UMeshWidgetComponent* Component)
+{
+	PendingRedraws.Add(Component);
+}
+
+void UMeshWidgetSubsystem::RegisterComponent(UInstancedMeshWidgetComponent* Component)
+{
+	InstancedComponents.AddUnique(Component);
+}
+
+void UMeshWidgetSubsystem::UnregisterComponent(UInstancedMeshWidgetComponent* Component)
+{
+	InstancedComponents.RemoveSingleSwap(Component);
+	for ( auto It = PendingInstanceRedraws.CreateIterator(); It; ++It )
+	{
+		if ( It->Key == Component )
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UMeshWidgetSubsystem::RequestRedrawSlot(UInstancedMeshWidgetComponent* Component, int32 InstanceIndex)
+{
+	PendingInstanceRedraws.Add(TPair<UInstancedMeshWidgetComponent*, int32>(Component, InstanceIndex));
+}
+
+void UMeshWidgetSubsystem::Tick(float DeltaTime)
+{
+	using namespace MeshWidgetSubsystem;
+
+	SCOPE_CYCLE_COUNTER(STAT_MeshWidgetSubsystemTick);
+
+	MeshWidgetScalability::UpdateQualityLevel();
+	UpdateLiveWidgetLimit();
+
+	RenderTargetPool->Trim();
+	UpdateRenderTargetBudget();
+
+	NumRedrawsLastFrame = 0;
+
+	for ( auto It = PendingRedraws.CreateIterator(); It; ++It )
+	{
+		const UMeshWidgetComponent* Component = *It;
+		if ( Component == nullptr || Component->IsPendingKill() || !Component->IsRegistered() )
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for ( auto It = PendingInstanceRedraws.CreateIterator(); It; ++It )
+	{
+		const UInstancedMeshWidgetComponent* Component = It->Key;
+		if ( Component == nullptr || Component->IsPendingKill() || !Component->IsRegistered() )
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	SET_DWORD_STAT(STAT_MeshWidgetNumPendingRedraws, GetNumPendingRedraws());
+
+	if ( GetNumPendingRedraws() == 0 )
+	{
+		return;
+	}
+
+	// Most urgent first, widgets and instances compete for the same budget
+	TArray<FScheduledRedraw> SortedRedraws;
+	SortedRedraws.Reserve(GetNumPendingRedraws());
+	for ( UMeshWidgetComponent* Component : PendingRedraws )
+	{
+		SortedRedraws.Add({ GetRedrawPriority(Component), Component, nullptr, INDEX_NONE });
+	}
+	for ( const TPair<UInstancedMeshWidgetComponent*, int32>& Redraw : PendingInstanceRedraws )
+	{
+		SortedRedraws.Add({ GetRedrawPriority(Redraw.Key, Redraw.Value), nullptr, Redraw.Key, Redraw.Value });
+	}
+	SortedRedraws.Sort([](const FScheduledRedraw& A, const FScheduledRedraw& B)
+	{
+		return A.Priority > B.Priority;
+	});
+
+	// Instances ask again on their next tick while they are due
+	PendingInstanceRedraws.Reset();
+
+	const double BudgetSeconds = CVarMeshWidgetFrameBudgetMs.GetValueOnGameThread() / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	const bool bDeferRenderTargetUpdates = CVarMeshWidgetDeferRenderTargetUpdates.GetValueOnGameThread() != 0;
+	const int32 MaxRedraws = MeshWidgetScalability::GetMaxRedrawsPerFrame();
+
+	for ( const FScheduledRedraw& Redraw : SortedRedraws )
+	{
+		if ( BudgetSeconds > 0.0 && NumRedrawsLastFrame > 0 && FPlatformTime::Seconds() - StartTime >= BudgetSeconds )
+		{
+			break;
+		}
+
+		if ( MaxRedraws > 0 && NumRedrawsLastFrame >= MaxRedraws )
+		{
+			break;
+		}
+
+		if ( UMeshWidgetComponent* Component = Redraw.Component )
+		{
+			PendingRedraws.Remove(Component);
+
+			// Only draws that happened use up the redraw limit
+			if ( Component->DrawWidgetToRenderTarget(DeltaTime, bDeferRenderTargetUpdates) )
+			{
+				NumRedrawsLastFrame++;
+			}
+		}
+		else if ( Redraw.InstancedComponent->DrawScheduledInstance(Redraw.InstanceIndex, DeltaTime) )
+		{
+			NumRedrawsLastFrame++;
+		}
+	}
+}
+
+void UMeshWidgetSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick InLevelTick, float InDeltaSeconds)
+{
+	if ( InWorld == GetWorld() )
+	{
+		GatherViews();
+	}
+}
+
+void UMeshWidgetSubsystem::GatherViews()
+{
+	Views.Reset();
+
+	UWorld* World = GetWorld();
+	if ( World == nullptr )
+	{
+		return;
+	}
+
+	for ( FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator )
+	{
+		APlayerController* PlayerController = Iterator->Get();
+		ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+		if ( LocalPlayer && LocalPlayer->ViewportClient && LocalPlayer->ViewportClient->Viewport )
+		{
+			FSceneViewProjectionData ProjectionData;
+			if ( LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, eSSP_FULL, ProjectionData) )
+			{
+				FMeshWidgetView& View = Views.AddDefaulted_GetRef();
+				View.Origin = ProjectionData.ViewOrigin;
+				View.Direction = ProjectionData.ViewRotationMatrix.GetColumn(2);
+				View.ProjectionMatrix = ProjectionData.ProjectionMatrix;
+				View.ViewRect = ProjectionData.GetConstrainedViewRect();
+
+				GetViewFrustumBounds(View.Frustum, ProjectionData.ComputeViewProjectionMatrix(), false);
+
+				FMatrix PreDrawProjectionMatrix = ProjectionData.ProjectionMatrix;
+				PreDrawProjectionMatrix.M[0][0] *= MeshWidgetSubsystem::PreDrawFrustumScale;
+				PreDrawProjectionMatrix.M[1][1] *= MeshWidgetSubsystem::PreDrawFrustumScale;
+				GetViewFrustumBounds(View.PreDrawFrustum, FTranslationMatrix(-ProjectionData.ViewOrigin) * ProjectionData.ViewRotationMatrix * PreDrawProjectionMatrix, false);
+			}
+		}
+	}
+}
+
+void UMeshWidgetSubsystem::UpdateLiveWidgetLimit()
+{
+	using namespace MeshWidgetSubsystem;
+
+	const int32 MaxLiveWidgets = MeshWidgetScalability::GetMaxLiveWidgets();
+
+	TArray<TPair<float, UMeshWidgetComponent*>> LiveWidgets;
+	for ( UMeshWidgetComponent* Component : Components )
+	{
+		if ( Component && !Component->IsPendingKill() && Component->CountsAsLiveWidget() )
+		{
+			const float Bonus = Component->IsFrozenByLiveWidgetLimit() ? 0.0f : LiveWidgetSignificanceBonus;
+			LiveWidgets.Emplace(GetSignificance(Component) + Bonus, Component);
+		}
+	}
+
+	// Most significant first
+	LiveWidgets.Sort([](const TPair<float, UMeshWidgetComponent*>& A, const TPair<float, UMeshWidgetComponent*>& B)
+	{
+		return A.Key > B.Key;
+	});
+
+	const int32 NumLive = MaxLiveWidgets > 0 ? FMath::Min(MaxLiveWidgets, LiveWidgets.Num()) : LiveWidgets.Num();
+
+	// Every freeze costs a draw and every thaw rebuilds the Slate resources, so a sudden change of view is spread
+	// over a few frames.  The least significant widgets freeze first, the most significant thaw first
+	int32 NumTransitions = 0;
+	for ( int32 WidgetIndex = LiveWidgets.Num() - 1; WidgetIndex >= NumLive && NumTransitions < MaxLiveWidgetTransitionsPerFrame; --WidgetIndex )
+	{
+		UMeshWidgetComponent* Component = LiveWidgets[WidgetIndex].Value;
+		if ( !Component->IsFrozenByLiveWidgetLimit() )
+		{
+			Component->SetFrozenByLiveWidgetLimit(true);
+			NumTransitions++;
+		}
+	}
+
+	for ( int32 WidgetIndex = 0; WidgetIndex < NumLive && NumTransitions < MaxLiveWidgetTransitionsPerFrame; ++WidgetIndex )
+	{
+		UMeshWidgetComponent* Component = LiveWidgets[WidgetIndex].Value;
+		if ( Component->IsFrozenByLiveWidgetLimit() )
+		{
+			Component->SetFrozenByLiveWidgetLimit(false);
+			NumTransitions++;
+		}
+	}
+}
+
+void UMeshWidgetSubsystem::UpdateRenderTargetBudget()
+{
+	using namespace MeshWidgetSubsystem;
+
+	// Widgets coming back into view get their render target back whatever the budget, the hidden ones make room for them
+	for ( UMeshWidgetComponent* Component : Components )
+	{
+		if ( Component && !Component->IsPendingKill() && Component->IsRenderTargetEvicted() && Component->IsInOrNearAnyView() )
+		{
+			Component->RestoreRenderTarget();
+			NumRenderTargetReacquisitions++;
+		}
+	}
+
+	const int64 Budget = GetRenderTargetBudget();
+	if ( Budget <= 0 )
+	{
+		return;
+	}
+
+	int64 UsedBytes = GetRenderTargetMemorySize();
+	if ( UsedBytes <= Budget )
+	{
+		return;
+	}
+
+	// Pooled render targets show nothing, they go first
+	const int64 FreeBytes = RenderTargetPool->GetFreeMemorySize();
+	RenderTargetPool->TrimToSize(FMath::Max<int64>(FreeBytes - ( UsedBytes - Budget ), 0));
+	UsedBytes -= FreeBytes - RenderTargetPool->GetFreeMemorySize();
+	if ( UsedBytes <= Budget )
+	{
+		return;
+	}
+
+	const EMeshWidgetEvictionPolicy Policy = GetEvictionPolicy();
+
+	TArray<TPair<float, UMeshWidgetComponent*>> Candidates;
+	for ( UMeshWidgetComponent* Component : Components )
+	{
+		if ( Component && !Component->IsPendingKill() && Component->CanEvictRenderTarget() && !Component->IsInOrNearAnyView() )
+		{
+			const float Rank = Policy == EMeshWidgetEvictionPolicy::LeastSignificant ? GetSignificance(Component) : Component->GetLastSeenTime();
+			Candidates.Emplace(Rank, Component);
+		}
+	}
+
+	// First to go first
+	Candidates.Sort([](const TPair<float, UMeshWidgetComponent*>& A, const TPair<float, UMeshWidgetComponent*>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	for ( const TPair<float, UMeshWidgetComponent*>& Candidate : Candidates )
+	{
+		if ( UsedBytes <= Budget )
+		{
+			break;
+		}
+
+		// A retired render target waiting for its swap is released along with the current one
+		UMeshWidgetComponent* Component = Candidate.Value;
+		UsedBytes -= Component->GetMemoryUsage().RenderTargetBytes;
+
+		Component->EvictRenderTarget();
+		NumRenderTargetEvictions++;
+	}
+
+	// Evicted render targets went back to the pool, which keeps what still fits in the budget
+	UsedBytes = GetRenderTargetMemorySize();
+	if ( UsedBytes > Budget )
+	{
+		RenderTargetPool->TrimToSize(FMath::Max<int64>(RenderTargetPool->GetFreeMemorySize() - ( UsedBytes - Budget ), 0));
+	}
+}
+
+int64 UMeshWidgetSubsystem::GetRenderTargetMemorySize() const
+{
+	int64 Bytes = RenderTargetPool ? RenderTargetPool->GetInUseMemorySize() + RenderTargetPool->GetFreeMemorySize() : 0;
+	for ( const FMeshWidgetAtlasPage& Page : AtlasPages )
+	{
+		if ( Page.RenderTarget )
+		{
+			Bytes += Page.RenderTarget->CalcTextureMemorySizeEnum(TMC_AllMips);
+		}
+	}
+
+	return Bytes;
+}
+
+FMeshWidgetRenderTargetPoolStats UMeshWidgetSubsystem::GetRenderTargetPoolStats() const
+{
+	return RenderTargetPool ? RenderTargetPool->GetStats() : FMeshWidgetRenderTargetPoolStats();
+}
+
+void UMeshWidgetSubsystem::DumpWidgets(FOutputDevice& Ar) const
+{
+	using namespace MeshWidgetSubsystem;
+
+	TArray<TPair<FMeshWidgetMemoryUsage, const UMeshWidgetComponent*>> Widgets;
+	for ( const UMeshWidgetComponent* Component : Components )
+	{
+		if ( Component && !Component->IsPendingKill() )
+		{
+			Widgets.Emplace(Component->GetMemoryUsage(), Component);
+		}
+	}
+
+	// Most expensive first
+	Widgets.Sort([](const TPair<FMeshWidgetMemoryUsage, const UMeshWidgetComponent*>& A, const TPair<FMeshWidgetMemoryUsage, const UMeshWidgetComponent*>& B)
+	{
+		return A.Key.GetTotalBytes() > B.Key.GetTotalBytes();
+	});
+
+	Ar.Logf(TEXT("Mesh widgets in %s: %d"), *GetWorld()->GetName(), Widgets.Num());
+	Ar.Logf(TEXT("%10s %10s %10s %10s %10s %8s %10s %11s  %-8s %-40s %s"),
+		TEXT("Total KB"), TEXT("RT KB"), TEXT("Widget KB"), TEXT("Slate KB"), TEXT("MID KB"), TEXT("Redraws"), TEXT("Last Draw"), TEXT("Draw Size"), TEXT("State"), TEXT("Owner"), TEXT("Class"));
+
+	FMeshWidgetMemoryUsage Total;
+	const UWorld* World = GetWorld();
+	for ( const TPair<FMeshWidgetMemoryUsage, const UMeshWidgetComponent*>& Entry : Widgets )
+	{
+		const FMeshWidgetMemoryUsage& Usage = Entry.Key;
+		const UMeshWidgetComponent* Component = Entry.Value;
+
+		Total.RenderTargetBytes += Usage.RenderTargetBytes;
+		Total.UserWidgetBytes += Usage.UserWidgetBytes;
+		Total.SlateBytes += Usage.SlateBytes;
+		Total.MaterialBytes += Usage.MaterialBytes;
+
+		const TCHAR* State = TEXT("Live");
+		if ( Component->GetMirrorSource() )
+		{
+			State = TEXT("Mirror");
+		}
+		else if ( Component->IsWidgetDormant() )
+		{
+			State = TEXT("Dormant");
+		}
+		else if ( Component->IsRenderTargetEvicted() )
+		{
+			State = TEXT("Evicted");
+		}
+		else if ( Component->IsFrozen() )
+		{
+			State = TEXT("Frozen");
+		}
+		else if ( Component->IsUsingSharedAtlas() )
+		{
+			State = TEXT("Atlas");
+		}
+
+		FString ClassName = TEXT("None");
+		if ( const UUserWidget* UserWidget = Component->GetUserWidgetObject() )
+		{
+			ClassName = UserWidget->GetClass()->GetName();
+		}
+		else if ( Component->GetWidgetClass() )
+		{
+			ClassName = Component->GetWidgetClass()->GetName();
+		}
+		else if ( Component->GetSlateWidget().IsValid() )
+		{
+			ClassName = Component->GetSlateWidget()->GetTypeAsString();
+		}
+
+		const FString Owner = Component->GetOwner() ? FString::Printf(TEXT("%s.%s"), *Component->GetOwner()->GetName(), *Component->GetName()) : Component->GetName();
+		const FString DrawSize = FString::Printf(TEXT("%dx%d"), FMath::RoundToInt(Component->GetDrawSize().X), FMath::RoundToInt(Component->GetDrawSize().Y));
+		const float TimeSinceDraw = Component->GetNumRedraws() > 0 ? World->TimeSince(Component->GetLastWidgetRenderTime()) : -1.0f;
+
+		Ar.Logf(TEXT("%10.1f %10.1f %10.1f %10.1f %10.1f %8d %9.1fs %11s  %-8s %-40s %s"),
+			ToKB(Usage.GetTotalBytes()), ToKB(Usage.RenderTargetBytes), ToKB(Usage.UserWidgetBytes), ToKB(Usage.SlateBytes), ToKB(Usage.MaterialBytes),
+			Component->GetNumRedraws(), TimeSinceDraw, *DrawSize, State, *Owner, *ClassName);
+	}
+
+	Ar.Logf(TEXT("%10.1f %10.1f %10.1f %10.1f %10.1f  Total"),
+		ToKB(Total.GetTotalBytes()), ToKB(Total.RenderTargetBytes), ToKB(Total.UserWidgetBytes), ToKB(Total.SlateBytes), ToKB(Total.MaterialBytes));
+
+	Ar.Logf(TEXT("Instanced mesh widgets in %s: %d"), *GetWorld()->GetName(), InstancedComponents.Num());
+	Ar.Logf(TEXT("%10s %11s %9s %11s  %-40s %s"), TEXT("Atlas KB"), TEXT("Atlas Size"), TEXT("Instances"), TEXT("Frame Draws"), TEXT("Owner"), TEXT("Class"));
+
+	for ( const UInstancedMeshWidgetComponent* Component : InstancedComponents )
+	{
+		if ( Component == nullptr || Component->IsPendingKill() )
+		{
+			continue;
+		}
+
+		const UTextureRenderTarget2D* Atlas = Component->GetRenderTarget();
+		const int64 AtlasBytes = Atlas ? Atlas->CalcTextureMemorySizeEnum(TMC_AllMips) : 0;
+		const FString AtlasSize = Atlas ? FString::Printf(TEXT("%dx%d"), Atlas->SizeX, Atlas->SizeY) : FString(TEXT("None"));
+		const FString Owner = Component->GetOwner() ? FString::Printf(TEXT("%s.%s"), *Component->GetOwner()->GetName(), *Component->GetName()) : Component->GetName();
+		const FString ClassName = Component->GetWidgetClass() ? Component->GetWidgetClass()->GetName() : FString(TEXT("None"));
+
+		Ar.Logf(TEXT("%10.1f %11s %9d %11d  %-40s %s"),
+			ToKB(AtlasBytes), *AtlasSize, Component->GetInstanceCount(), Component->GetNumRedrawsLastFrame(), *Owner, *ClassName);
+	}
+
+	const FMeshWidgetRenderTargetPoolStats PoolStats = GetRenderTargetPoolStats();
+	Ar.Logf(TEXT("Render target pool: %d in use (%.2f MB), %d free (%.2f MB), %d hits, %d misses, %d trimmed"),
+		PoolStats.NumInUse, PoolStats.InUseMemoryMB, PoolStats.NumFree, PoolStats.FreeMemoryMB, PoolStats.NumHits, PoolStats.NumMisses, PoolStats.NumTrimmed);
+
+	const FMeshWidgetRenderTargetBudgetStats BudgetStats = GetRenderTargetBudgetStats();
+	Ar.Logf(TEXT("Render target budget: %.2f MB used of %.2f MB, %d atlas pages, %d evicted, %d evictions, %d reacquisitions"),
+		BudgetStats.UsedMB, BudgetStats.BudgetMB, AtlasPages.Num(), BudgetStats.NumEvicted, BudgetStats.NumEvictions, BudgetStats.NumReacquisitions);
+}
+
+FMeshWidgetRenderTargetBudgetStats UMeshWidgetSubsystem::GetRenderTargetBudgetStats() const
+{
+	FMeshWidgetRenderTargetBudgetStats Stats;
+	Stats.BudgetMB = FMath::Max(CVarMeshWidgetRenderTargetBudgetMB.GetValueOnGameThread(), 0.0f);
+	Stats.UsedMB = GetRenderTargetMemorySize() / (1024.0f * 1024.0f);
+	Stats.Policy = MeshWidgetSubsystem::GetEvictionPolicy();
+	Stats.NumEvictions = NumRenderTargetEvictions;
+	Stats.NumReacquisitions = NumRenderTargetReacquisitions;
+
+	for ( const UMeshWidgetComponent* Component : Components )
+	{
+		if ( Component && Component->IsRenderTargetEvicted() )
+		{
+			Stats.NumEvicted++;
+		}
+	}
+
+	return Stats;
+}
+
+float UMeshWidgetSubsystem::GetScreenCoverage(const UPrimitiveComponent* Component) const
+{
+	return GetScreenCoverage(Component->Bounds);
+}
+
+float UMeshWidgetSubsystem::GetScreenCoverage(const FBoxSphereBounds& Bounds) const
+{
+	float Coverage = 0.0f;
+	for ( const FMeshWidgetView& View : Views )
+	{
+		const float ScreenSize = ComputeBoundsScreenSize(Bounds.Origin, Bounds.SphereRadius, View.Origin, View.ProjectionMatrix);
+		Coverage = FMath::Max(Coverage, ScreenSize);
+	}
+
+	return FMath::Min(Coverage, 1.0f);
+}
+
+float UMeshWidgetSubsystem::GetProjectedSize(const UPrimitiveComponent* Component) const
+{
+	float ProjectedSize = 0.0f;
+	for ( const FMeshWidgetView& View : Views )
+	{
+		// The screen size is relative to the larger dimension of the view
+		const float ScreenSize = ComputeBoundsScreenSize(Component->Bounds.Origin, Component->Bounds.SphereRadius, View.Origin, View.ProjectionMatrix);
+		ProjectedSize = FMath::Max(ProjectedSize, ScreenSize * FMath::Max(View.ViewRect.Width(), View.ViewRect.Height()));
+	}
+
+	return ProjectedSize;
+}
+
+EMeshWidgetViewVisibility UMeshWidgetSubsystem::GetViewVisibility(const UPrimitiveComponent* Component) const
+{
+	return GetViewVisibility(Component->Bounds);
+}
+
+EMeshWidgetViewVisibility UMeshWidgetSubsystem::GetViewVisibility(const FBoxSphereBounds& Bounds) const
+{
+	if ( Views.Num() == 0 )
+	{
+		return EMeshWidgetViewVisibility::Unknown;
+	}
+
+	EMeshWidgetViewVisibility Visibility = EMeshWidgetViewVisibility::Hidden;
+	for ( const FMeshWidgetView& View : Views )
+	{
+		if ( View.Frustum.IntersectBox(Bounds.Origin, Bounds.BoxExtent) )
+		{
+			return EMeshWidgetViewVisibility::InView;
+		}
+
+		if ( View.PreDrawFrustum.IntersectBox(Bounds.Origin, Bounds.BoxExtent) )
+		{
+			Visibility = EMeshWidgetViewVisibility::NearView;
+		}
+	}
+
+	return Visibility;
+}
+
+float UMeshWidgetSubsystem::GetSignificance(const UMeshWidgetComponent* Component) const
+{
+	using namespace MeshWidgetSubsystem;
+
+	if ( Views.Num() == 0 || Component->IsHovered() )
+	{
+		return 1.0f;
+	}
+
+	float Significance = 0.0f;
+	for ( const FMeshWidgetView& View : Views )
+	{
+		const FVector ToWidget = Component->Bounds.Origin - View.Origin;
+		const float Distance = FMath::Max(ToWidget.Size() - Component->Bounds.SphereRadius, 0.0f);
+		const float ScreenSize = ComputeBoundsScreenSize(Component->Bounds.Origin, Component->Bounds.SphereRadius, View.Origin, View.ProjectionMatrix);
+
+		const float SizeFactor = FMath::Clamp(ScreenSize / SignificantScreenSize, 0.0f, 1.0f);
+		const float DistanceFactor = Distance > SignificantDistance ? SignificantDistance / Distance : 1.0f;
+
+		// Anything inside the bounds counts as looked at
+		const float AngleCos = Distance > 0.0f ? FVector::DotProduct(View.Direction, ToWidget.GetSafeNormal()) : 1.0f;
+		const float AngleFactor = FMath::SmoothStep(PeripheralConeCos, FocusConeCos, AngleCos);
+
+		// Looking at a widget makes it fully significant, out of focus what is large and close still matters more
+		const float FocusFactor = AngleFactor * FMath::Clamp(ScreenSize / FocusScreenSize, 0.0f, 1.0f);
+		const float PeripheralFactor = ( SizeFactor * SizeSignificanceWeight + DistanceFactor * DistanceSignificanceWeight ) * PeripheralSignificanceScale;
+
+		Significance = FMath::Max(Significance, FMath::Max(FocusFactor, PeripheralFactor));
+	}
+
+	const UUserWidget* UserWidget = Component->GetUserWidgetObject();
+	if ( UserWidget && UserWidget->IsAnyAnimationPlaying() )
+	{
+		Significance += AnimationSignificanceBonus;
+	}
+
+	return FMath::Min(Significance, 1.0f);
+}
+
+float UMeshWidgetSubsystem::GetRedrawPriority(const UMeshWidgetComponent* Component) const
+{
+	float Priority = GetScreenCoverage(Component) * MeshWidgetSubsystem::CoverageWeight;
+
+	if ( Component->IsHovered() )
+	{
+		Priority += MeshWidgetSubsystem::HoveredBonus;
+	}
+
+	Priority += GetWorld()->TimeSince(Component->GetLastWidgetRenderTime()) * MeshWidgetSubsystem::WaitingWeight;
+
+	return Priority;
+}
+
+float UMeshWidgetSubsystem::GetRedrawPriority(const UInstancedMeshWidgetComponent* Component, int32 InstanceIndex) const
+{
+	if ( !Component->Instances.IsValidIndex(InstanceIndex) )
+	{
+		return 0.0f;
+	}
+
+	const FMeshWidgetInstance& Instance = Component->Instances[InstanceIndex];
+
+	float Priority = GetScreenCoverage(Component->GetInstanceBounds(InstanceIndex)) * MeshWidgetSubsystem::CoverageWeight;
+
+	// Requested redraws are what keeps a hovered instance responsive
+	if ( Instance.bRedrawRequested )
+	{
+		Priority += MeshWidgetSubsystem::HoveredBonus;
+	}
+
+	Priority += GetWorld()->TimeSince(Instance.LastWidgetRenderTime) * MeshWidgetSubsystem::WaitingWeight;
+
+	return Priority;
+}
+
+UTextureRenderTarget2D* UMeshWidgetSubsystem::AllocateAtlasRegion(FIntPoint RegionSize, FIntRect& OutRegion)
+{
+	using namespace MeshWidgetSubsystem;
+
+	if ( RegionSize.X <= 0 || RegionSize.Y <= 0 || RegionSize.X > MaxAtlasPageSize / 2 || RegionSize.Y > MaxAtlasPageSize / 2 )
+	{
+		return nullptr;
+	}
+
+	for ( FMeshWidgetAtlasPage& Page : AtlasPages )
+	{
+		if ( Page.Allocator.Allocate(RegionSize, OutRegion) )
+		{
+			return Page.RenderTarget;
+		}
+	}
+
+	// Fewer, bigger pages mean fewer texture binds, so grow before adding a page
+	for ( FMeshWidgetAtlasPage& Page : AtlasPages )
+	{
+		while ( Page.Allocator.GetSize().X < MaxAtlasPageSize )
+		{
+			ResizeAtlasPage(Page, Page.Allocator.GetSize() * 2);
+
+			if ( Page.Allocator.Allocate(RegionSize, OutRegion) )
+			{
+				return Page.RenderTarget;
+			}
+		}
+	}
+
+	const int32 PageSize = FMath::Max<int32>(InitialAtlasPageSize, FMath::RoundUpToPowerOfTwo(FMath::Max(RegionSize.X, RegionSize.Y) * 2));
+
+	FMeshWidgetAtlasPage& Page = AtlasPages.AddDefaulted_GetRef();
+	Page.Allocator = FMeshWidgetAtlasAllocator(FIntPoint(PageSize, PageSize));
+	Page.RenderTarget = NewObject<UTextureRenderTarget2D>(this);
+	Page.RenderTarget->ClearColor = FLinearColor::Transparent;
+	Page.RenderTarget->InitCustomFormat(PageSize, PageSize, PF_B8G8R8A8, false);
+
+	verify(Page.Allocator.Allocate(RegionSize, OutRegion));
+	return Page.RenderTarget;
+}
+
+void UMeshWidgetSubsystem::ReleaseAtlasRegion(UTextureRenderTarget2D* RenderTarget, const FIntRect& Region)
+{
+	const int32 PageIndex = AtlasPages.IndexOfByPredicate([RenderTarget](const FMeshWidgetAtlasPage& Page) { return Page.RenderTarget == RenderTarget; });
+	if ( PageIndex == INDEX_NONE )
+	{
+		return;
+	}
+
+	FMeshWidgetAtlasPage& Page = AtlasPages[PageIndex];
+	Page.Allocator.Release(Region);
+
+	// Keep one empty page around so a widget popping in and out doesn't reallocate it every time
+	if ( Page.Allocator.IsEmpty() && AtlasPages.Num() > 1 )
+	{
+		AtlasPages.RemoveAt(PageIndex);
+	}
+}
+
+void UMeshWidgetSubsystem::ResizeAtlasPage(FMeshWidgetAtlasPage& Page, FIntPoint NewSize)
+{
+	Page.Allocator.Resize(NewSize);
+	Page.RenderTarget->ResizeTarget(NewSize.X, NewSize.Y);
+
+	for ( UMeshWidgetComponent* Component : Components )
+	{
+		if ( Component && Component->IsUsingSharedAtlas() && Component->GetRenderTarget() == Page.RenderTarget )
+		{
+			Component->OnSharedAtlasResized();
+		}
+	}
+}
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+MESHWIDGET_API DECLARE_LOG_CATEGORY_EXTERN(LogMeshWidget, Log, All);
 
 /**
  * The public interface to this module.  In most cases, this interface is only public to sibling modules 
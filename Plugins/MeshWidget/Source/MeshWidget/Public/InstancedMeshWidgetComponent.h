@@ -0,0 +1,251 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/WidgetComponent.h"
+#include "Runtime/UMG/Public/Blueprint/UserWidget.h"
+#include "MeshWidgetAtlasAllocator.h"
+
+#include "InstancedMeshWidgetComponent.generated.h"
+
+class UTextureRenderTarget2D;
+
+/** The widget shown on one instance of an instanced mesh widget component. */
+USTRUCT()
+struct FMeshWidgetInstance
+{
+	GENERATED_BODY()
+
+	/** The user widget displayed on the instance */
+	UPROPERTY(Transient)
+	UUserWidget* Widget = nullptr;
+
+	/** The slate window that contains the user widget content */
+	TSharedPtr<class SVirtualWindow> SlateWindow;
+
+	/** The grid used to find the widgets under a hit, filled when the widget is drawn */
+	TSharedPtr<class FHittestGrid> HitTestGrid;
+
+	/** The region of the atlas the widget is drawn into, empty until the atlas has room for it */
+	FIntRect AtlasRegion;
+
+	/** The world time at which the widget was last drawn */
+	float LastWidgetRenderTime = 0.0f;
+
+	/** Has anyone requested we redraw? */
+	bool bRedrawRequested = true;
+};
+
+/**
+ * Beware! This feature is experimental and may be substantially changed or removed in future releases.
+ * Shows a separate instance of a Widget Blueprint on every instance of an instanced static mesh.
+ *
+ * All instances draw into regions of one atlas render target and are rendered with a single material, so
+ * rows of identical screens cost as many draw calls as the mesh has sections.  The region of each instance
+ * reaches the material through the first four floats of the per-instance custom data, as the UV scale (0, 1)
+ * and offset (2, 3) of the region in the atlas.
+ *
+ * Instances due for a redraw ask the world's UMeshWidgetSubsystem for a slot, so they share the frame budget and
+ * the redraw limits with every other mesh widget, and the atlas is taken from the subsystem's render target pool.
+ *
+ * AtlasMaterial parameters:
+ * SlateUI [Texture]
+ * BackColor [Vector]
+ */
+UCLASS(Blueprintable, ClassGroup=Experimental, hidecategories=(Object,Activation,"Components|Activation",Sockets,Base,Lighting,LOD,Mesh), editinlinenew, meta=(BlueprintSpawnableComponent, DevelopmentStatus=Experimental) )
+class MESHWIDGET_API UInstancedMeshWidgetComponent : public UInstancedStaticMeshComponent
+{
+	GENERATED_UCLASS_BODY()
+
+	friend class UMeshWidgetSubsystem;
+
+public:
+	/** UActorComponent Interface */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	virtual void DestroyComponent(bool bPromoteChildren = false) override;
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+
+	/* UPrimitiveComponent Interface */
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+
+	// Begin UInstancedStaticMeshComponent
+	virtual int32 AddInstance(const FTransform& InstanceTransform) override;
+	virtual bool RemoveInstance(int32 InstanceIndex) override;
+	virtual void ClearInstances() override;
+	// End UInstancedStaticMeshComponent
+
+	/** Release resources associated with the widgets. */
+	virtual void ReleaseResources();
+
+	/** @return The user widget displayed on an instance */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	UUserWidget* GetInstanceWidget(int32 InstanceIndex) const;
+
+	/** Sets the user widget displayed on an instance, replacing the one created from WidgetClass. */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	void SetInstanceWidget(int32 InstanceIndex, UUserWidget* InWidget);
+
+	/** Requests that the widget of an instance be redrawn. */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	void RequestInstanceRedraw(int32 InstanceIndex);
+
+	/** Requests that the widgets of every instance be redrawn. */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	void RequestRedraw();
+
+	/**
+	 * Converts a world-space hit result to a hit location on the widget of the instance that was hit.
+	 * @param Hit The hit on this component in the world, Hit.Item is the instance
+	 * @return The 2D hit location on the widget, in DrawSize units
+	 */
+	FVector2D GetLocalHitLocation(const FHitResult& Hit) const;
+
+	/**
+	 * Converts a location on the widget of an instance, in DrawSize units, to the space the widget is painted and
+	 * hit tested in.  Pointer events sent to the widget need to be in this space.
+	 */
+	FVector2D LocalToWindowLocation(int32 InstanceIndex, const FVector2D& LocalLocation) const;
+
+	/** @return List of widgets under the hit on the instance Hit.Item, with their geometry and the cursor position. */
+	TArray<FWidgetAndPointer> GetHitWidgetPath(const FHitResult& Hit, bool bIgnoreEnabledStatus, float CursorRadius = 0.0f);
+
+	/** @return The render target all the instances are drawn into */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	UTextureRenderTarget2D* GetRenderTarget() const { return RenderTarget; }
+
+	/** @return The dynamic material instance used to render the widgets */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	UMaterialInstanceDynamic* GetMaterialInstance() const { return MaterialInstance; }
+
+	/** @return The class of User Widget created for every mesh instance */
+	TSubclassOf<UUserWidget> GetWidgetClass() const { return WidgetClass; }
+
+	/** @return The draw size of the widget of each instance */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	FVector2D GetDrawSize() const { return FVector2D(DrawSize); }
+
+	/** @return Number of widgets drawn during the last frame */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	int32 GetNumRedrawsLastFrame() const { return NumRedrawsLastFrame; }
+
+	/** Sets the background color of the widgets */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	void SetBackgroundColor( const FLinearColor NewBackgroundColor );
+
+protected:
+	/** Creates the widget, window and hit test grid of instances that don't have them yet. */
+	void InitInstance(FMeshWidgetInstance& Instance);
+
+	/** Releases the widget, window and hit test grid of an instance and gives its region back to the atlas. */
+	void ReleaseInstance(FMeshWidgetInstance& Instance);
+
+	/** Matches the widget instances to the mesh instances, which the editor may change without going through AddInstance. */
+	void SyncInstances();
+
+	/**
+	 * Gives every instance without one a region of the atlas, growing the atlas if needed, and writes the
+	 * regions to the per-instance custom data.
+	 */
+	void UpdateAtlasLayout();
+
+	/** Writes the UV scale and offset of every instance's region to its custom data and updates the render state once. */
+	void UpdateInstanceCustomData();
+
+	/** Swaps the atlas for a render target of the given size from the world's pool.  The contents are lost. */
+	void AcquireAtlasRenderTarget(FIntPoint AtlasSize);
+
+	/** Returns the atlas to the world's pool. */
+	void ReleaseAtlasRenderTarget();
+
+	/** @return True if the widget of the instance should be drawn this frame */
+	bool ShouldDrawInstance(int32 InstanceIndex) const;
+
+	/** Draws the widget of one instance into its region of the atlas. */
+	void DrawInstanceToRenderTarget(int32 InstanceIndex, float DeltaTime);
+
+	/**
+	 * Draws an instance the subsystem gave a redraw slot to, unless it stopped being due since it asked.
+	 * @return True if the instance was drawn
+	 */
+	bool DrawScheduledInstance(int32 InstanceIndex, float DeltaTime);
+
+	/** @return The bounds of one instance in world space */
+	FBoxSphereBounds GetInstanceBounds(int32 InstanceIndex) const;
+
+protected:
+	/** The class of User Widget to create an instance of for every mesh instance */
+	UPROPERTY(EditAnywhere, Category=UserInterface)
+	TSubclassOf<UUserWidget> WidgetClass;
+
+	/** The size of the widget of each instance, which is also the size of its region of the atlas. */
+	UPROPERTY(EditAnywhere, Category=UserInterface)
+	FIntPoint DrawSize;
+
+	/**
+	 * The time in between draws of an instance, if 0 - we would redraw every frame.  If 1, we would redraw
+	 * every second.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface)
+	float RedrawTime;
+
+	/**
+	 * The most instances that ask for a redraw per frame.  Requested redraws go first, then the instances that
+	 * waited longest.  If 0, every instance due for a redraw asks.  r.MeshWidget.FrameBudgetMs and the redraw
+	 * limit of the scalability settings apply on top, across all the mesh widgets of the world.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface, meta=(ClampMin=0))
+	int32 MaxRedrawsPerFrame;
+
+	/** Should instances be drawn when they are off screen? */
+	UPROPERTY(EditAnywhere, Category=Animation)
+	bool TickWhenOffscreen;
+
+	/** Is the virtual window created to host each widget focusable? */
+	UPROPERTY(EditAnywhere, Category=UserInterface)
+	bool bWindowFocusable;
+
+	/** The background color of the widgets */
+	UPROPERTY(EditAnywhere, Category=Rendering)
+	FLinearColor BackgroundColor;
+
+	/**
+	 * The material the instances are rendered with.  It must sample SlateUI at UV * PerInstanceCustomData[0, 1]
+	 * + PerInstanceCustomData[2, 3].
+	 */
+	UPROPERTY(EditAnywhere, Category=Rendering)
+	UMaterialInterface* AtlasMaterial;
+
+	/** The widgets of the instances, in the same order as the mesh instances */
+	UPROPERTY(Transient, DuplicateTransient)
+	TArray<FMeshWidgetInstance> Instances;
+
+	/** The atlas every instance is drawn into */
+	UPROPERTY(Transient, DuplicateTransient)
+	UTextureRenderTarget2D* RenderTarget;
+
+	/** Tracks which regions of the atlas are in use */
+	FMeshWidgetAtlasAllocator AtlasAllocator;
+
+	/** Do some instances need a region or new UVs? */
+	bool bAtlasLayoutDirty;
+
+	/** The dynamic instance of AtlasMaterial */
+	UPROPERTY(Transient, DuplicateTransient)
+	UMaterialInstanceDynamic* MaterialInstance;
+
+	/** How many widgets were drawn in the last frame */
+	int32 NumRedrawsLastFrame;
+
+	/** The instance of the last hit */
+	int32 LastHitInstanceIndex;
+
+	/** The relative location of the last hit on LastHitInstanceIndex */
+	FVector2D LastLocalHitLocation;
+
+	/** Helper class for drawing widgets to a render target. */
+	TSharedPtr<class FWidgetRenderer> WidgetRenderer;
+};
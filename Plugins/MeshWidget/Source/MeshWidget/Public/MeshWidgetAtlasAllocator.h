@@ -0,0 +1,72 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Packs rectangular regions into a 2D atlas using shelves: rows of regions sharing a height.
+ * Released regions go back to the free spans of their shelf and can be reused by regions that fit.
+ * The atlas can grow, which keeps every allocated region where it is.
+ */
+class MESHWIDGET_API FMeshWidgetAtlasAllocator
+{
+public:
+	explicit FMeshWidgetAtlasAllocator(FIntPoint InSize = FIntPoint::ZeroValue, int32 InPadding = 2);
+
+	/**
+	 * Finds room for a region.
+	 * @param RegionSize The size of the region in texels
+	 * @param OutRegion (Out) The allocated region
+	 * @return False if the atlas has no room left for the region
+	 */
+	bool Allocate(FIntPoint RegionSize, FIntRect& OutRegion);
+
+	/** Returns a region obtained from Allocate to the atlas. */
+	void Release(const FIntRect& Region);
+
+	/** Grows the atlas.  Allocated regions keep their place, shrinking is not supported. */
+	void Resize(FIntPoint NewSize);
+
+	/** @return The size of the atlas in texels */
+	FIntPoint GetSize() const { return Size; }
+
+	/** @return The number of allocated regions */
+	int32 GetNumRegions() const { return NumRegions; }
+
+	/** @return True if no region is allocated */
+	bool IsEmpty() const { return NumRegions == 0; }
+
+	/** @return The fraction of the atlas area covered by allocated regions */
+	float GetUsage() const;
+
+private:
+	/** A row of regions */
+	struct FShelf
+	{
+		/** Top of the shelf */
+		int32 Y;
+
+		/** Height of the shelf, including padding */
+		int32 Height;
+
+		/** Free horizontal spans as (start, width), sorted by start */
+		TArray<FIntPoint> FreeSpans;
+	};
+
+	/** @return The index of the first span of the shelf that can hold Width, or INDEX_NONE */
+	static int32 FindFreeSpan(const FShelf& Shelf, int32 Width);
+
+	/** Takes Width from the start of a free span of the shelf and returns the region. */
+	FIntRect AllocateFromShelf(FShelf& Shelf, int32 SpanIndex, FIntPoint RegionSize, int32 Width);
+
+	TArray<FShelf> Shelves;
+
+	FIntPoint Size;
+
+	int32 Padding;
+
+	int32 NumRegions;
+
+	int64 AllocatedArea;
+};
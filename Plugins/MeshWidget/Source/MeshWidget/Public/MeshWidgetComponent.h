@@ -5,10 +5,13 @@
 #include "CoreMinimal.h"
 #include "Components/WidgetComponent.h"
 #include "Runtime/UMG/Public/Blueprint/UserWidget.h"
+#include "RenderCommandFence.h"
 
 #include "MeshWidgetComponent.generated.h"
 
 struct FVirtualPointerPosition;
+enum class EMeshWidgetViewVisibility : uint8;
+class UTexture;
 
 //UENUM(BlueprintType)
 //enum class EWidgetBlendMode : uint8
@@ -18,6 +21,82 @@ struct FVirtualPointerPosition;
 //	Transparent
 //};
 
+/** Pixel formats a mesh widget render target can use.  Smaller formats save memory and bandwidth. */
+UENUM(BlueprintType)
+enum class EMeshWidgetRenderTargetFormat : uint8
+{
+	/** 8 bits per channel with alpha, works with every blend mode */
+	RGBA8,
+	/** 10 bits per color channel and 2 bits of alpha, enough for opaque and masked widgets */
+	RGB10A2,
+	/** A single 8 bit channel for monochrome widgets, needs a SingleChannelMaterial and an opaque blend mode */
+	R8,
+	/** 16 bit float per channel with alpha, for widgets with HDR colors */
+	RGBA16F,
+	/** Packed float color without alpha, for opaque widgets with HDR colors */
+	RG11B10F,
+};
+
+/** A material instance created for one base material, with the parameter values last set on it. */
+USTRUCT()
+struct FMeshWidgetMaterialInstance
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	UMaterialInstanceDynamic* Instance = nullptr;
+
+	TMap<FName, float> ScalarValues;
+
+	TMap<FName, FLinearColor> VectorValues;
+
+	TMap<FName, const UTexture*> TextureValues;
+};
+
+/** A widget class a mesh widget switches to when it is small on screen. */
+USTRUCT(BlueprintType)
+struct FMeshWidgetClassLOD
+{
+	GENERATED_BODY()
+
+	/** The LOD is used once the projected size of the widget, in pixels, falls below this */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=UserInterface, meta=(ClampMin=0.0f))
+	float ProjectedSize = 0.0f;
+
+	/** The class of User Widget to show, if none the widget is frozen into its texture */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=UserInterface)
+	TSubclassOf<UUserWidget> WidgetClass;
+};
+
+/** When the mip chain of a mesh widget render target is regenerated. */
+UENUM(BlueprintType)
+enum class EMeshWidgetMipGeneration : uint8
+{
+	/** The render target has no mips */
+	None,
+	/** Regenerate the mips after every redraw */
+	EveryRedraw,
+	/** Regenerate the mips only after redraws where the widget changed */
+	OnChange,
+};
+
+/** The memory a mesh widget holds on to, in bytes, split by what it is spent on. */
+struct FMeshWidgetMemoryUsage
+{
+	/** The render target, or the widget's share of an atlas page, and a retired render target still shown */
+	int64 RenderTargetBytes = 0;
+
+	/** The user widget and the UMG widgets of its tree */
+	int64 UserWidgetBytes = 0;
+
+	/** The virtual window, the hit test grids and the widget renderer */
+	int64 SlateBytes = 0;
+
+	/** The dynamic material instance */
+	int64 MaterialBytes = 0;
+
+	int64 GetTotalBytes() const { return RenderTargetBytes + UserWidgetBytes + SlateBytes + MaterialBytes; }
+};
 
 /**
  * Beware! This feature is experimental and may be substantially changed or removed in future releases.
@@ -28,12 +107,15 @@ struct FVirtualPointerPosition;
  * TintColorAndOpacity [Vector]
  * OpacityFromTexture [Scalar]
  * ParabolaDistortion [Scalar]
+ * CursorTexture [Texture], CursorUV [Vector], CursorSize [Vector], with bUseMaterialCursor
  */
 UCLASS(Blueprintable, ClassGroup=Experimental, hidecategories=(Object,Activation,"Components|Activation",Sockets,Base,Lighting,LOD,Mesh), editinlinenew, meta=(BlueprintSpawnableComponent, DevelopmentStatus=Experimental) )
 class MESHWIDGET_API UMeshWidgetComponent : public UStaticMeshComponent
 {
 	GENERATED_UCLASS_BODY()
 
+	friend class UMeshWidgetSubsystem;
+
 public:
 	/** UActorComponent Interface */
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason);
@@ -48,6 +130,7 @@ public:
 
 	// Begin UObject
 	virtual void PostLoad() override;
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
 	// End UObject
 
 	// Begin MeshComponent
@@ -70,11 +153,87 @@ public:
 	/** Release resources associated with the widget. */
 	virtual void ReleaseResources();
 
+	/**
+	 * Draws the widget one last time and releases everything but the render target: the user widget (if it can be
+	 * created again from WidgetClass), the virtual window, the hit test grid and the widget renderer.  The
+	 * component keeps showing the last drawn texture until it is thawed.
+	 */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	void Freeze();
+
+	/** Recreates the widget and the Slate resources released by Freeze and redraws. */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	void Thaw();
+
+	/** @return True if the widget is frozen into its texture */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	bool IsFrozen() const { return bFrozen; }
+
+	/** @return True if the widget isn't created yet, or was released after going unseen, and waits to be seen */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	bool IsWidgetDormant() const { return bWidgetDormant; }
+
+	/** @return True if the widget counts against r.MeshWidget.MaxLiveWidgets: it has a widget that isn't frozen for another reason */
+	bool CountsAsLiveWidget() const;
+
+	/** @return True if the widget is frozen to stay within r.MeshWidget.MaxLiveWidgets */
+	bool IsFrozenByLiveWidgetLimit() const { return bFrozenByLiveWidgetLimit; }
+
+	/**
+	 * Freezes or thaws the widget for r.MeshWidget.MaxLiveWidgets, called by the subsystem.  Unlike Freeze, the
+	 * last draw waits for a redraw slot and only the Slate resources are released, the user widget keeps its state.
+	 */
+	void SetFrozenByLiveWidgetLimit(bool bInFrozen);
+
+	/** @return True if the render target was released to stay within r.MeshWidget.RenderTargetBudgetMB */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	bool IsRenderTargetEvicted() const { return bRenderTargetEvicted; }
+
+	/** @return True if the widget owns a render target that the subsystem may release while nobody sees it, and can draw it again */
+	bool CanEvictRenderTarget() const;
+
+	/** Releases the render target to stay within the render target budget, called by the subsystem. */
+	void EvictRenderTarget();
+
+	/**
+	 * Draws the widget into a new render target after an eviction, called by the subsystem once the widget is seen
+	 * again.  A widget frozen by its class LOD or the live widget limit is drawn once and stays frozen.
+	 */
+	void RestoreRenderTarget();
+
+	/** @return True if the widget or one of its mirrors is in or near a player view, or if there are no views */
+	bool IsInOrNearAnyView() const;
+
+	/** @return The last world time the widget or one of its mirrors was rendered on screen */
+	float GetLastSeenTime() const;
+
+	/** @return The widget class LOD in use, 0 for WidgetClass and N for WidgetClassLODs[N - 1] */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	int32 GetWidgetClassLOD() const { return WidgetClassLOD; }
+
+	/**
+	 * Shows the render target of another mesh widget instead of drawing a widget of our own.  The source draws
+	 * once for all its mirrors whenever one of them is seen, and input on a mirror goes to the source's widget.
+	 * The component's own widget and render target are released while mirroring.  A source that mirrors
+	 * another component is followed to the component that actually draws.
+	 * @param NewSource The widget to show, or nullptr to draw our own widget again
+	 */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	void SetMirrorSource(UMeshWidgetComponent* NewSource);
+
+	/** @return The mesh widget whose render target this component shows, nullptr if it draws its own */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	UMeshWidgetComponent* GetMirrorSource() const { return MirrorSource; }
+
 	/** Ensures the 3d window is created its size and content. */
 	virtual void UpdateWidget();
 
-	/** Ensure the render target is initialized and updates it if needed. */
-	virtual void UpdateRenderTarget(FIntPoint DesiredRenderTargetSize);
+	/**
+	 * Ensure the render target is initialized and updates it if needed.
+	 * @param DesiredRenderTargetSize The size of the render target, or of the atlas region, to allocate
+	 * @param UsedRenderTargetSize The part of the allocation the widget is drawn into, all of it if zero
+	 */
+	virtual void UpdateRenderTarget(FIntPoint DesiredRenderTargetSize, FIntPoint UsedRenderTargetSize = FIntPoint::ZeroValue);
 
 	/**
 	 * Converts a world-space hit result to a hit location on the widget
@@ -102,10 +261,31 @@ public:
 	/** @return List of widgets with their geometry and the cursor position transformed into this Widget component's space. */
 	TArray<FWidgetAndPointer> GetHitWidgetPath(const FHitResult& Hit, bool bIgnoreEnabledStatus, float CursorRadius = 0.0f);
 
+	/** @return List of widgets under a location on the widget, in DrawSize units, with their geometry and the cursor position. */
+	TArray<FWidgetAndPointer> GetHitWidgetPathAtLocation(const FVector2D& LocalHitLocation, bool bIgnoreEnabledStatus, float CursorRadius = 0.0f);
+
 	/** @return The render target to which the user widget is rendered */
 	UFUNCTION(BlueprintCallable, Category=UserInterface)
 	UTextureRenderTarget2D* GetRenderTarget() const;
 
+	/** @return True if the widget draws into a region of a render target shared with other mesh widgets */
+	bool IsUsingSharedAtlas() const { return bDrawingToSharedAtlas; }
+
+	/** @return The resolution LOD the widget is drawn at, each level halves the render target resolution */
+	int32 GetResolutionLOD() const { return ResolutionLOD; }
+
+	/** @return The region of the render target the widget is drawn into */
+	FIntRect GetRenderTargetRegion() const { return RenderTargetRegion; }
+
+	/** Called by the subsystem when the shared atlas page holding this widget was resized. */
+	void OnSharedAtlasResized();
+
+	/**
+	 * Converts a location on the widget, in DrawSize units, to the space the widget is painted and hit tested in.
+	 * Pointer events sent to the widget need to be in this space.
+	 */
+	FVector2D LocalToWindowLocation(const FVector2D& LocalLocation) const;
+
 	/** @return The dynamic material instance used to render the user widget */
 	UFUNCTION(BlueprintCallable, Category=UserInterface)
 	UMaterialInstanceDynamic* GetMaterialInstance() const;
@@ -150,12 +330,72 @@ public:
 	UFUNCTION(BlueprintCallable, Category=UserInterface)
 	virtual void RequestRedraw();
 
+	/** @return The time to wait between draws, RedrawTime or the time picked by the adaptive redraw rate, capped by r.MeshWidget.MaxRedrawRate */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	float GetEffectiveRedrawTime() const;
+
+	/** @return How significant the widget was this frame, between 0 and 1, used by the adaptive redraw rate */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	float GetRedrawSignificance() const { return RedrawSignificance; }
+
+	/** @return The world time at which the widget was last drawn to the render target */
+	float GetLastWidgetRenderTime() const { return LastWidgetRenderTime; }
+
+	/** @return Number of times the widget was drawn to the render target since it was created */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	int32 GetNumRedraws() const { return NumRedraws; }
+
+	/** @return The memory held by the widget, its render target, its Slate resources and its material */
+	FMeshWidgetMemoryUsage GetMemoryUsage() const;
+
+	/** @return The part of the widget's region repainted by the last draw, 1 for a full repaint */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	float GetLastRedrawCoverage() const { return LastRedrawCoverage; }
+
+	/** @return Number of draws that replayed the draw elements cached by the invalidation panel */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	int32 GetInvalidationCacheHits() const;
+
+	/** @return Number of draws where the invalidation panel had to repaint the whole widget */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	int32 GetInvalidationCacheMisses() const;
+
+	/** Sets the invalidation panel cache counters back to 0. */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	void ResetInvalidationCacheCounters();
+
+	/** Called every frame by interaction components that are hovering this widget. */
+	void MarkHovered()
+	{
+		LastHoveredFrame = GFrameCounter;
+		if ( MirrorSource )
+		{
+			MirrorSource->MarkHovered();
+		}
+	}
+
+	/** @return True if an interaction component hovered this widget this frame or the previous one */
+	bool IsHovered() const { return LastHoveredFrame + 1 >= GFrameCounter; }
+
 	/** Gets the blend mode for the widget. */
 	EWidgetBlendMode GetBlendMode() const { return BlendMode; }
 
 	/** Sets the blend mode to use for this widget */
 	void SetBlendMode( const EWidgetBlendMode NewBlendMode );
 
+	/** Gets the requested render target format, see GetRenderTargetPixelFormat for the one actually used. */
+	EMeshWidgetRenderTargetFormat GetRenderTargetFormat() const { return RenderTargetFormat; }
+
+	/** Sets the pixel format of the render target, it is recreated on the next draw */
+	UFUNCTION(BlueprintCallable, Category=Rendering)
+	void SetRenderTargetFormat( const EMeshWidgetRenderTargetFormat NewRenderTargetFormat );
+
+	/** @return The pixel format the render target is created with, RGBA8 if the requested format can't be used */
+	EPixelFormat GetRenderTargetPixelFormat() const { return RenderTargetPixelFormat; }
+
+	/** @return Why the requested render target format can't be used with the current settings, empty if it can */
+	const FString& GetRenderTargetFormatError() const { return RenderTargetFormatError; }
+
 	/** Sets whether the widget is two-sided or not */
 	void SetTwoSided( const bool bWantTwoSided );
 
@@ -169,6 +409,18 @@ public:
 	/** Sets how much opacity from the UI widget's texture alpha is used when rendering to the viewport (0.0-1.0) */
 	void SetOpacityFromTexture( const float NewOpacityFromTexture );
 
+	/** @return True if the pointer of an interaction component is drawn by the material instead of the widget */
+	bool UsesMaterialCursor() const { return bUseMaterialCursor; }
+
+	/**
+	 * Moves the material cursor, which only updates material parameters and doesn't redraw the widget.
+	 * @param LocalLocation The location of the pointer on the widget, in DrawSize units
+	 */
+	void SetMaterialCursorLocation(const FVector2D& LocalLocation);
+
+	/** Hides the material cursor until it is moved again. */
+	void HideMaterialCursor();
+
 	/** @return The pivot point where the UI is rendered about the origin. */
 	FVector2D GetPivot() const { return Pivot; }
 
@@ -183,6 +435,11 @@ public:
 	/** Updates the dynamic parameters on the material instance, without re-creating it */
 	void UpdateMaterialInstanceParameters();
 
+	/** Set a parameter on the material instance unless it already has that value. */
+	void SetMaterialScalarParameter(FName ParameterName, float Value);
+	void SetMaterialVectorParameter(FName ParameterName, const FLinearColor& Value);
+	void SetMaterialTextureParameter(FName ParameterName, UTexture* Value);
+
 	/** Sets the widget class used to generate the widget for this component */
 	void SetWidgetClass(TSubclassOf<UUserWidget> InWidgetClass);
 
@@ -194,11 +451,168 @@ protected:
 	void RegisterWindow();
 	void UnregisterWindow();
 
+	/** Releases the window, hit test grid and widget renderer, keeping the render target. */
+	void ReleaseSlateResources();
+
 	/** Allows subclasses to control if the widget should be drawn.  Called right before we draw the widget. */
 	virtual bool ShouldDrawWidget() const;
 
-	/** Draws the current widget to the render target if possible. */
-	virtual void DrawWidgetToRenderTarget(float DeltaTime);
+	/** Tests the widget against the current player views and last frame's occlusion results. */
+	void UpdateViewVisibility();
+
+	/** @return True if the widget is seen or about to be seen, so drawing it is worth it */
+	bool IsInOrNearView() const;
+
+	/** @return True if a mirror showing this widget is seen or about to be seen */
+	bool IsAnyMirrorInOrNearView() const;
+
+	/** @return True if the widget or one of its mirrors is seen, about to be seen or hovered, so its resources are needed */
+	bool IsWidgetNeeded() const;
+
+	/** Creates the resources of a dormant widget and draws it. */
+	void WakeWidget();
+
+	/** Releases the widget, its Slate resources and its render target until it is needed again. */
+	void ReleaseUnneededWidget();
+
+	/** Releases the user widget, if it can be created again from its class, and the Slate resources. */
+	void ReleaseWidgetResources();
+
+	/** Freezes the widget once the scheduler has drawn it one last time, so the draw counts against the frame budget. */
+	void RequestFreeze();
+
+	/** Releases what the widget doesn't need once frozen, its texture showing the last draw. */
+	void CompleteFreeze();
+
+	/**
+	 * Draws a frozen widget whose texture was lost once more, from the user widget it was frozen from or a new one
+	 * of its class, and freezes it again for the same reason after that draw.
+	 */
+	void RedrawFrozenWidget();
+
+	/** Creates the widget renderer, the user widget and the Slate resources again and redraws. */
+	void RecreateWidgetResources();
+
+	/** Lets the widget take over the state of the widget it replaces, if its class implements MeshWidgetLODInterface. */
+	void CopyLODStateFrom(UUserWidget* PreviousWidget);
+
+	/** @return The state saved by the widget through MeshWidgetLODInterface, null if its class doesn't implement it */
+	static UObject* SaveLODStateOf(UUserWidget* InWidget);
+
+	/** Hands the state saved before a static impostor to the widget, if its class implements MeshWidgetLODInterface. */
+	void RestoreLODStateFrom(UObject* SavedState);
+
+	/** Called by the mirror source when its render target or region changed. */
+	void OnMirrorSourceUpdated();
+
+	/** Lets the mirrors pick up the current render target and region. */
+	void NotifyMirrors();
+
+	/** Stops mirroring and makes our mirrors draw their own widgets, for when the component goes away. */
+	void UnlinkMirrors();
+
+	/**
+	 * Draws the current widget to the render target if possible.
+	 * @param bAllowDeferredUpdate Let the render target update be batched with the other deferred widget updates
+	 *                             that the Slate renderer runs in one pass when it draws the windows this frame
+	 * @return True if the widget was drawn
+	 */
+	virtual bool DrawWidgetToRenderTarget(float DeltaTime, bool bAllowDeferredUpdate = false);
+
+	/** @return True if the layout may have changed since the desired size was last measured */
+	bool NeedsDesiredSizePrepass(float LayoutScale) const;
+
+	/** @return The render target size to allocate for a used size, snapped to a step with hysteresis against the current allocation */
+	FIntPoint SnapRenderTargetSize(FIntPoint UsedRenderTargetSize) const;
+
+	/**
+	 * @return True if the materials showing the render target, ours and the mirrors', sample only the widget's
+	 * region through AtlasUVScaleOffset, so the render target may be bigger than the widget
+	 */
+	bool CanSampleRenderTargetRegion() const;
+
+	/** @return True if nothing enqueued around the draw depends on the render target being updated right away */
+	bool CanDeferRenderTargetUpdate() const;
+
+	/** @return The color the widget's region of the render target is cleared to before drawing, adjusted to the format */
+	FLinearColor GetRenderTargetClearColor() const;
+
+	/**
+	 * Works out the pixel format the render target is created with, once per settings change rather than per
+	 * draw, and logs a warning if the requested format falls back to RGBA8.
+	 */
+	void ValidateRenderTargetFormat();
+
+	/** @return Why the requested render target format can't be used with the current settings, empty if it can */
+	FString ComputeRenderTargetFormatError() const;
+
+	/** Logs a warning if bUseMaterialCursor is set but the material has no cursor parameters to draw it with. */
+	void ValidateMaterialCursor() const;
+
+	/** @return True if the render target gets a mip chain */
+	bool UsesMips() const;
+
+	/** @return True if the mips have to be regenerated after the draw that produced the given widget signature */
+	bool ShouldGenerateMips(uint32 WidgetSignature) const;
+
+	/**
+	 * Picks the resolution LOD from the projected size of the bounds on screen.
+	 * @return True if the LOD changed
+	 */
+	bool UpdateResolutionLOD();
+
+	/** @return The largest projected size of this widget and its mirrors over the views, in pixels */
+	float GetProjectedSizeWithMirrors() const;
+
+	/**
+	 * Picks the widget class LOD from the projected size on screen and switches to it, handing the state of the
+	 * previous widget to the new one.
+	 * @return True if the LOD changed
+	 */
+	bool UpdateWidgetClassLOD();
+
+	/** @return The widget class of a class LOD, null for one that freezes the widget */
+	TSubclassOf<UUserWidget> GetLODWidgetClass(int32 InWidgetClassLOD) const;
+
+	/** @return The UV scale (R, G) and offset (B, A) of the widget's region in its render target */
+	FLinearColor GetRenderTargetRegionScaleOffset() const;
+
+	/** Gives the render target back to the render target pool, or the widget's region back to the shared atlas. */
+	void ReleaseRenderTarget();
+
+	/** @return The render target the material samples, the retired one until a resized render target is drawn */
+	UTextureRenderTarget2D* GetDisplayedRenderTarget() const { return RetiredRenderTarget ? RetiredRenderTarget : RenderTarget; }
+
+	/** Shows the render target that replaced the retired one once its first draw is done on the render thread. */
+	void UpdateRenderTargetSwap();
+
+	/** Gives the retired render target back to the render target pool. */
+	void ReleaseRetiredRenderTarget();
+
+	/** @return A render target of the given size, from the world's render target pool if there is one */
+	UTextureRenderTarget2D* AcquireRenderTarget(FIntPoint Size, const FLinearColor& ClearColor);
+
+	/** @return True if the widget may look different than when it was last drawn. */
+	bool HasWidgetChanged() const;
+
+	/**
+	 * @return A hash of the state of the hosted widget tree that decides how it is painted.  The tree is walked once
+	 * per frame, later calls in the same frame reuse that walk.
+	 */
+	uint32 ComputeWidgetSignature() const;
+
+	/** Makes the next ComputeWidgetSignature walk the tree again, after its content was replaced. */
+	void InvalidateWidgetSignature();
+
+	/** Sets the content of the slate window, through the invalidation panel and dirty region host if they are used. */
+	void SetWindowContent(const TSharedRef<SWidget>& InContent);
+
+	/**
+	 * Finds the part of the render target region the next draw has to repaint.
+	 * @param OutPaintRegion (Out) The region to repaint, may be empty if nothing changed
+	 * @return False if the whole region has to be repainted
+	 */
+	bool ComputeDirtyRegion(FIntRect& OutPaintRegion);
 protected:
 
 	/** The class of User Widget to create and display an instance of */
@@ -213,6 +627,51 @@ protected:
 	UPROPERTY(EditAnywhere, Category=UserInterface)
 	bool bManuallyRedraw;
 
+	/**
+	 * Should we only redraw when the widget may look different?  A redraw happens when one is requested, when
+	 * an animation is playing or when the visible state of the widget tree (visibility, text, hover, focus,
+	 * render transforms...) changed since the last draw.  Otherwise the GPU draw and render target update
+	 * are skipped.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface)
+	bool bRedrawOnlyWhenChanged;
+
+	/**
+	 * With bRedrawOnlyWhenChanged, the longest time an unchanged widget goes without being redrawn, so changes
+	 * that don't show up in the widget state (brush colors, progress bar fill...) are still picked up.
+	 * If 0, unchanged widgets are never redrawn.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface, meta=(EditCondition="bRedrawOnlyWhenChanged", ClampMin=0.0f))
+	float MaxUnchangedRedrawInterval;
+
+	/**
+	 * Only repaints the part of the render target where widgets changed since the last draw and keeps the rest.
+	 * Widgets outside of that part are neither painted nor ticked until the next full repaint, except for the
+	 * root of the user widget.  Adding, removing, showing, hiding or transforming widgets repaints everything.
+	 * Widgets that paint brushes or colors (images, borders, progress bars) are repainted by every draw, only
+	 * panels and text blocks are skipped while unchanged.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface, AdvancedDisplay)
+	bool bUseDirtyRegions;
+
+	/** Repaints everything instead once the changed part covers more than this fraction of the widget. */
+	UPROPERTY(EditAnywhere, Category=UserInterface, AdvancedDisplay, meta=(EditCondition="bUseDirtyRegions", ClampMin=0.0f, ClampMax=1.0f))
+	float DirtyRegionFullRepaintThreshold;
+
+	/**
+	 * The longest time between full repaints, which catch changes the dirty regions miss and refresh the hit
+	 * test grid.  If 0, only changes that need it cause a full repaint.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface, AdvancedDisplay, meta=(EditCondition="bUseDirtyRegions", ClampMin=0.0f))
+	float DirtyRegionFullRepaintInterval;
+
+	/**
+	 * Hosts the widget in an invalidation panel, which retains its draw elements between draws.  Draws replay
+	 * them and only repaint the widgets that were invalidated, instead of painting the whole hierarchy.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface, AdvancedDisplay)
+	bool bUseInvalidationPanel;
+
 	/** Has anyone requested we redraw? */
 	UPROPERTY()
 	bool bRedrawRequested;
@@ -222,13 +681,118 @@ protected:
 	 * This will work with bManuallyRedraw as well.  So you can say, manually redraw, but only redraw at this
 	 * maximum rate.
 	 */
-	UPROPERTY(EditAnywhere, Category=UserInterface)
+	UPROPERTY(EditAnywhere, Category=UserInterface, meta=(EditCondition="!bAdaptiveRedrawRate"))
 	float RedrawTime;
 
+	/**
+	 * Replaces RedrawTime with a rate picked every frame between MinRedrawRate and MaxRedrawRate from how
+	 * significant the widget is: its size on screen, distance, angle from the view direction, hover state and
+	 * running animations.  Widgets a player looks at redraw at the max rate, peripheral ones at the min rate.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface)
+	bool bAdaptiveRedrawRate;
+
+	/** Redraws per second of a widget nobody pays attention to */
+	UPROPERTY(EditAnywhere, Category=UserInterface, meta=(EditCondition="bAdaptiveRedrawRate", ClampMin=0.1f, UIMin=0.1f))
+	float MinRedrawRate;
+
+	/** Redraws per second of a widget a player looks at */
+	UPROPERTY(EditAnywhere, Category=UserInterface, meta=(EditCondition="bAdaptiveRedrawRate", ClampMin=0.1f, UIMin=0.1f))
+	float MaxRedrawRate;
+
+	/** The significance from this frame, between 0 and 1 */
+	float RedrawSignificance;
+
 	/** What was the last time we rendered the widget? */
 	UPROPERTY()
 	float LastWidgetRenderTime;
 
+	/** How many times the widget was drawn since the component was created */
+	int32 NumRedraws;
+
+	/** The last frame an interaction component hovered this widget */
+	uint64 LastHoveredFrame;
+
+	/** The widget signature at the time of the last draw */
+	uint32 LastDrawnWidgetSignature;
+
+	/** The hash of the widget tree from the last walk, without the draw size */
+	mutable uint32 WidgetTreeSignature;
+
+	/** The frame WidgetTreeSignature was computed in */
+	mutable uint64 WidgetTreeSignatureFrame;
+
+	/** The text of the tree at the last walk */
+	mutable TSharedPtr<class FMeshWidgetTextCache> SignatureTextCache;
+
+	/** Should a frozen widget thaw when an interaction component hovers it? */
+	UPROPERTY(EditAnywhere, Category=UserInterface)
+	bool bThawOnHover;
+
+	/** Is the widget frozen into its texture? */
+	bool bFrozen;
+
+	/**
+	 * Wait until the widget is first in or near a view, or hovered, to create the user widget, the virtual window
+	 * and the render target.  Until then only the mesh is rendered.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface)
+	bool bDeferWidgetCreation;
+
+	/**
+	 * Seconds the widget may go unseen and unhovered before it releases the user widget (if it can be created again
+	 * from WidgetClass), the virtual window and the render target, and waits to be seen again like a widget with
+	 * bDeferWidgetCreation.  If 0, the widget is never released.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface, meta=(ClampMin=0.0f, Units=s))
+	float ReleaseWhenUnseenTime;
+
+	/** Is the widget waiting to be seen before its resources are created? */
+	bool bWidgetDormant;
+
+	/** The last world time the widget or one of its mirrors was in or near a view, or hovered */
+	float LastNeededTime;
+
+	/**
+	 * Simpler widget classes to show when the widget is small on screen, ordered from the largest projected size
+	 * to the smallest.  A LOD without a class freezes the widget into its texture, as a static impostor, and
+	 * releases it.  Widgets implementing MeshWidgetLODInterface take over the state of the widget they replace,
+	 * or the state it saved before an impostor.  Only applies to widgets created from WidgetClass.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface)
+	TArray<FMeshWidgetClassLOD> WidgetClassLODs;
+
+	/** The widget class LOD in use */
+	int32 WidgetClassLOD;
+
+	/** Was the widget frozen by a class LOD rather than by Freeze? */
+	bool bFrozenByClassLOD;
+
+	/** Was the widget frozen by the subsystem to stay within r.MeshWidget.MaxLiveWidgets? */
+	bool bFrozenByLiveWidgetLimit;
+
+	/** Does the widget freeze after its next draw? */
+	bool bFreezePending;
+
+	/** Was the render target released by the subsystem to stay within r.MeshWidget.RenderTargetBudgetMB? */
+	bool bRenderTargetEvicted;
+
+	/** The state saved by the widget a class LOD froze, for the widget that comes next; the widget itself is released */
+	UPROPERTY(Transient, DuplicateTransient)
+	UObject* LODState;
+
+	/** The class of the widget a class LOD froze, to draw the impostor again after its texture was lost */
+	UPROPERTY(Transient, DuplicateTransient)
+	TSubclassOf<UUserWidget> LODStateWidgetClass;
+
+	/** The mesh widget whose render target we show instead of drawing our own */
+	UPROPERTY(Transient, DuplicateTransient)
+	UMeshWidgetComponent* MirrorSource;
+
+	/** The mesh widgets showing our render target */
+	UPROPERTY(Transient, DuplicateTransient)
+	TArray<UMeshWidgetComponent*> Mirrors;
+
 	/** Is the virtual window created to host the widget focusable? */
 	UPROPERTY(EditAnywhere, Category=UserInterface)
 	bool bWindowFocusable;
@@ -241,7 +805,15 @@ protected:
 	FIntPoint CurrentDrawSize;
 
 	/**
-	 * Causes the render target to automatically match the desired size.
+	 * Causes the render target to automatically match the desired size.  The widget is laid out at its desired
+	 * size.  If the material has an AtlasUVScaleOffset parameter and samples SlateUI at UV * AtlasUVScaleOffset.RG
+	 * + AtlasUVScaleOffset.BA, like the atlas materials, the render target is allocated in steps of 32 pixels and
+	 * only shrinks once the desired size is two steps smaller, so small changes don't resize it.  With the default
+	 * materials it matches the desired size exactly.
+	 *
+	 * The desired size is only measured again when the widget signature changes, an animation plays, or at least
+	 * once a second, so size changes the signature can't see (brushes, progress values, text that isn't in a text
+	 * block) show with the previous layout for up to a second.
 	 * 
 	 * WARNING: If you change this every frame, it will be very expensive.  If you need 
 	 *    that effect, you should keep the outer widget's sized locked and dynamically
@@ -250,6 +822,35 @@ protected:
 	UPROPERTY(EditAnywhere, Category=UserInterface)
 	bool bDrawAtDesiredSize;
 
+	/** Has the desired size been measured since the widget was created? */
+	bool bHasDesiredSizePrepass;
+
+	/** The widget signature when the desired size was last measured */
+	uint32 DesiredSizePrepassSignature;
+
+	/** The layout scale the desired size was last measured with */
+	float DesiredSizePrepassScale;
+
+	/** The world time the desired size was last measured at */
+	float DesiredSizePrepassTime;
+
+	/**
+	 * Lowers the render target resolution in power of two steps when the widget covers only a small part of
+	 * the screen.  Layout and hit testing still happen at DrawSize.
+	 */
+	UPROPERTY(EditAnywhere, Category=UserInterface)
+	bool bUseResolutionLOD;
+
+	/** The lowest resolution used by the resolution LOD, as the number of times DrawSize is halved. */
+	UPROPERTY(EditAnywhere, Category=UserInterface, meta=(EditCondition="bUseResolutionLOD", ClampMin=0, ClampMax=6))
+	int32 MaxResolutionLOD;
+
+	/** The resolution LOD currently in use */
+	int32 ResolutionLOD;
+
+	/** The scale from DrawSize to render target texels used by the last draw */
+	float CurrentDrawScale;
+
 	/** The Alignment/Pivot point that the widget is placed at relative to the position. */
 	UPROPERTY(EditAnywhere, Category=UserInterface)
 	FVector2D Pivot;
@@ -280,6 +881,65 @@ protected:
 	UPROPERTY()
 	bool bIsOpaque_DEPRECATED;
 
+	/**
+	 * The pixel format of the render target.  Formats with little or no alpha are only valid with the blend modes
+	 * that don't need it, otherwise RGBA8 is used and a warning is logged.  Ignored with bUseSharedAtlas.
+	 */
+	UPROPERTY(EditAnywhere, Category=Rendering)
+	EMeshWidgetRenderTargetFormat RenderTargetFormat;
+
+	/**
+	 * Store the widget without sRGB encoding.  The material then samples the values Slate wrote without converting
+	 * them to linear.  Has no effect on the float formats, which are always linear.
+	 */
+	UPROPERTY(EditAnywhere, Category=Rendering, AdvancedDisplay)
+	bool bForceLinearGamma;
+
+	/**
+	 * The material used with the R8 format.  Widget materials sample all four channels of SlateUI, this one has to
+	 * use the red channel as the color (a grayscale sampler does that) and treat the widget as opaque.
+	 */
+	UPROPERTY(EditAnywhere, Category=Rendering)
+	UMaterialInterface* SingleChannelMaterial;
+
+	/** The pixel format the render target is created with, as of the last ValidateRenderTargetFormat */
+	EPixelFormat RenderTargetPixelFormat;
+
+	/** Why RenderTargetFormat can't be used, as of the last ValidateRenderTargetFormat */
+	FString RenderTargetFormatError;
+
+	/**
+	 * Gives the render target a mip chain, which keeps distant widgets and widgets seen at grazing angles from
+	 * aliasing.  Generating the mips costs a compute or draw pass per redraw.  Ignored with bUseSharedAtlas.
+	 */
+	UPROPERTY(EditAnywhere, Category=Rendering)
+	EMeshWidgetMipGeneration MipGeneration;
+
+	/** The filter used to downsample each mip from the previous one and to sample between mips */
+	UPROPERTY(EditAnywhere, Category=Rendering, meta=(EditCondition="MipGeneration != EMeshWidgetMipGeneration::None"))
+	TEnumAsByte<TextureFilter> MipFilter;
+
+	/** The widget signature at the time the mips were last generated */
+	uint32 LastMipsWidgetSignature;
+
+	/** Do the mips have to be generated on the next draw regardless of MipGeneration? */
+	bool bMipsDirty;
+
+	/**
+	 * Draw into a region of a render target shared with other mesh widgets instead of a render target of its own.
+	 * Meant for scenes with many small widgets.  Needs an AtlasMaterial, as the default materials sample the whole
+	 * render target.
+	 */
+	UPROPERTY(EditAnywhere, Category=Rendering)
+	bool bUseSharedAtlas;
+
+	/**
+	 * The material used when drawing into a shared atlas.  It must sample SlateUI at UV * AtlasUVScaleOffset.RG
+	 * + AtlasUVScaleOffset.BA, otherwise the same parameters as the default widget materials apply.
+	 */
+	UPROPERTY(EditAnywhere, Category=Rendering, meta=(EditCondition="bUseSharedAtlas"))
+	UMaterialInterface* AtlasMaterial;
+
 	/** Is the component visible from behind? */
 	UPROPERTY(EditAnywhere, Category=Rendering)
 	bool bIsTwoSided;
@@ -292,10 +952,47 @@ protected:
 	UPROPERTY(EditAnywhere, Category=Rendering)
 	float ParabolaDistortion;
 
+	/**
+	 * Draws the pointer of interaction components in the material, as CursorTexture placed at CursorUV, so moving
+	 * the pointer only updates material parameters.  The widget is only redrawn when the hovered widgets change
+	 * or a pointer key is held.  None of the default materials draw the cursor, a warning is logged when the
+	 * material is missing the parameters.  To draw it, add to the material:
+	 *  - a CursorTexture texture parameter (clamped), sampled at (UV - CursorUV.RG) / CursorSize.RG
+	 *  - CursorUV and CursorSize vector parameters
+	 *  - a mask of CursorUV.B, zeroed where that sample UV is outside 0-1
+	 *  - a lerp from the SlateUI color to the cursor color by the cursor alpha times the mask
+	 */
+	UPROPERTY(EditAnywhere, Category=Rendering)
+	bool bUseMaterialCursor;
+
+	/** The texture of the material cursor, its top left corner is the hot spot */
+	UPROPERTY(EditAnywhere, Category=Rendering, meta=(EditCondition="bUseMaterialCursor"))
+	UTexture* CursorTexture;
+
+	/** The size of the material cursor, in DrawSize units.  It reaches the material in UV units as CursorSize (R, G) */
+	UPROPERTY(EditAnywhere, Category=Rendering, meta=(EditCondition="bUseMaterialCursor"))
+	FVector2D CursorSize;
+
+	/** The UV of the pointer (R, G) and whether the cursor is shown (B), as last passed to the material */
+	FLinearColor CursorUV;
+
 	/** Should the component tick the widget when it's off screen? */
 	UPROPERTY(EditAnywhere, Category=Animation)
 	bool TickWhenOffscreen;
 
+	/**
+	 * Should the widget stop redrawing while it is occluded?  Uses the occlusion results of the previous frame,
+	 * so a widget coming out from behind an occluder shows one stale frame.
+	 */
+	UPROPERTY(EditAnywhere, Category=Animation)
+	bool bSkipRedrawWhenOccluded;
+
+	/** Where the widget is relative to the player views this frame */
+	EMeshWidgetViewVisibility ViewVisibility;
+
+	/** Was the widget in view but hidden by occlusion last frame? */
+	bool bOccluded;
+
 	/** The User Widget object displayed and managed by this component */
 	UPROPERTY(Transient, DuplicateTransient)
 	UUserWidget* Widget;
@@ -334,10 +1031,44 @@ protected:
 	UPROPERTY(Transient, DuplicateTransient)
 	UTextureRenderTarget2D* RenderTarget;
 
+	/**
+	 * The render target that RenderTarget replaced when the size or format changed.  The material keeps sampling
+	 * it until the first draw into the new one is done, so the swap neither waits for the render thread nor
+	 * shows an empty render target for a frame.
+	 */
+	UPROPERTY(Transient, DuplicateTransient)
+	UTextureRenderTarget2D* RetiredRenderTarget;
+
+	/** The region of RetiredRenderTarget the widget was drawn into */
+	FIntRect RetiredRenderTargetRegion;
+
+	/** Completes once the first draw into RenderTarget after it replaced RetiredRenderTarget is done */
+	FRenderCommandFence RenderTargetSwapFence;
+
+	/** Has the first draw into the new render target been enqueued, and the fence begun after it? */
+	bool bRenderTargetSwapFenceBegun;
+
+	/** Is RenderTarget a shared atlas page that we own a region of? */
+	bool bDrawingToSharedAtlas;
+
+	/** The region of RenderTarget the widget is drawn into */
+	FIntRect RenderTargetRegion;
+
+	/** The region of RenderTarget reserved for the widget, RenderTargetRegion is the part of it in use */
+	FIntRect RenderTargetAllocation;
+
 	/** The dynamic instance of the material that the render target is attached to */
 	UPROPERTY(Transient, DuplicateTransient)
 	UMaterialInstanceDynamic* MaterialInstance;
 
+	/** The base material MaterialInstance was created from */
+	UPROPERTY(Transient, DuplicateTransient)
+	UMaterialInterface* MaterialInstanceBase;
+
+	/** Material instances created so far, reused when the scene proxy is recreated */
+	UPROPERTY(Transient, DuplicateTransient)
+	TMap<UMaterialInterface*, FMeshWidgetMaterialInstance> MaterialInstanceCache;
+
 	UPROPERTY()
 	bool bUseLegacyRotation;
 
@@ -358,6 +1089,27 @@ protected:
 	/** The slate window that contains the user widget content */
 	TSharedPtr<class SVirtualWindow> SlateWindow;
 
+	/** Hosts the window content and limits its paint to the dirty region, if dirty regions are used */
+	TSharedPtr<class SMeshWidgetDirtyRegion> DirtyRegionHost;
+
+	/** Retains the draw elements of the window content, if the invalidation panel is used */
+	TSharedPtr<class SMeshWidgetInvalidationPanel> InvalidationPanel;
+
+	/** Diffs the widget tree between draws to find the dirty region */
+	TSharedPtr<class FMeshWidgetDirtyRegionTracker> DirtyRegionTracker;
+
+	/** Filled by partial repaints, which only see part of the widgets, so HitTestGrid keeps the last full one */
+	TSharedPtr<class FHittestGrid> PartialHitTestGrid;
+
+	/** Does the next draw have to repaint the whole region? */
+	bool bFullRepaintNeeded;
+
+	/** The world time of the last full repaint */
+	float LastFullRepaintTime;
+
+	/** The part of the region repainted by the last draw */
+	float LastRedrawCoverage;
+
 	/** The relative location of the last hit on this component */
 	FVector2D LastLocalHitLocation;
 
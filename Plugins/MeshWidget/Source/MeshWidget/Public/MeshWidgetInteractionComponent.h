@@ -11,6 +11,7 @@
 
 class UPrimitiveComponent;
 class AActor;
+class UInstancedMeshWidgetComponent;
 
 /**
  * The interaction source for the widget interaction component, e.g. where do we try and
@@ -132,6 +133,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Interaction")
 	UMeshWidgetComponent* GetHoveredMeshWidgetComponent() const;
 
+	/**
+	 * Get the currently hovered instanced mesh widget component and the index of the hovered instance.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Interaction")
+	UInstancedMeshWidgetComponent* GetHoveredInstancedMeshWidgetComponent(int32& OutInstanceIndex) const;
+
 	/**
 	 * Returns true if a widget under the hit result is interactive.  e.g. Slate widgets 
 	 * that return true for IsInteractable().
@@ -283,6 +290,14 @@ protected:
 	UPROPERTY(Transient)
 	UMeshWidgetComponent* HoveredMeshWidgetComponent;
 
+	/** The instanced mesh widget component we're currently hovering over. */
+	UPROPERTY(Transient)
+	UInstancedMeshWidgetComponent* HoveredInstancedMeshWidgetComponent;
+
+	/** The instance of HoveredInstancedMeshWidgetComponent we're currently hovering over. */
+	UPROPERTY(Transient)
+	int32 HoveredInstanceIndex;
+
 	/** The last hit result we used. */
 	UPROPERTY(Transient)
 	FHitResult LastHitResult;
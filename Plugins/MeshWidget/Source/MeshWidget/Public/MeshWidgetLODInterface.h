@@ -0,0 +1,47 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+
+#include "MeshWidgetLODInterface.generated.h"
+
+class UUserWidget;
+
+UINTERFACE(BlueprintType)
+class MESHWIDGET_API UMeshWidgetLODInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Implemented by the widgets of mesh widget class LODs that carry state across LOD switches, such as the
+ * selected tab or the text typed so far.
+ */
+class MESHWIDGET_API IMeshWidgetLODInterface
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Called on the widget created for a new class LOD, before it is first drawn.
+	 * @param PreviousWidget The widget of the LOD that was shown before, which is discarded afterwards
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category=UserInterface)
+	void CopyLODState(UUserWidget* PreviousWidget);
+
+	/**
+	 * Called on the widget before a class LOD without a class freezes it into a static impostor and releases it.
+	 * @return An object holding the state the widget shown after the impostor should start from, or null
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category=UserInterface)
+	UObject* SaveLODState();
+
+	/**
+	 * Called instead of CopyLODState on a widget created after a static impostor, before it is first drawn.
+	 * @param SavedState The object returned by SaveLODState of the widget the impostor was frozen from
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category=UserInterface)
+	void RestoreLODState(UObject* SavedState);
+};
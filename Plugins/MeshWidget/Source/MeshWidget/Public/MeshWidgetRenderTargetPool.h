@@ -0,0 +1,147 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Engine/Texture.h"
+
+#include "MeshWidgetRenderTargetPool.generated.h"
+
+class UTextureRenderTarget2D;
+
+/** Everything that has to match for a pooled render target to be reused as is. */
+struct MESHWIDGET_API FMeshWidgetRenderTargetDesc
+{
+	FMeshWidgetRenderTargetDesc(FIntPoint InSize, EPixelFormat InFormat, bool bInForceLinearGamma, const FLinearColor& InClearColor, bool bInMips = false, TextureFilter InMipsFilter = TF_Default);
+
+	/** Describes an existing render target */
+	explicit FMeshWidgetRenderTargetDesc(const UTextureRenderTarget2D* RenderTarget);
+
+	bool operator==(const FMeshWidgetRenderTargetDesc& Other) const;
+
+	FIntPoint Size;
+
+	EPixelFormat Format;
+
+	bool bForceLinearGamma;
+
+	/** The clear color is baked into the render target resource when it is created */
+	FLinearColor ClearColor;
+
+	/** Whether the render target has a mip chain */
+	bool bMips;
+
+	/** The sampler filter used when sampling the mips */
+	TextureFilter MipsFilter;
+};
+
+/** Counters of a mesh widget render target pool. */
+USTRUCT(BlueprintType)
+struct MESHWIDGET_API FMeshWidgetRenderTargetPoolStats
+{
+	GENERATED_BODY()
+
+	/** Render targets handed out and not returned yet */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	int32 NumInUse = 0;
+
+	/** Render targets waiting in the pool to be reused */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	int32 NumFree = 0;
+
+	/** Memory used by the render targets in use, in megabytes */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	float InUseMemoryMB = 0.0f;
+
+	/** Memory used by the render targets waiting in the pool, in megabytes */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	float FreeMemoryMB = 0.0f;
+
+	/** Requests served with a pooled render target */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	int32 NumHits = 0;
+
+	/** Requests that had to create a render target */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	int32 NumMisses = 0;
+
+	/** Pooled render targets destroyed by trimming */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	int32 NumTrimmed = 0;
+};
+
+/** A render target waiting in the pool. */
+USTRUCT()
+struct FMeshWidgetPooledRenderTarget
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	UTextureRenderTarget2D* RenderTarget = nullptr;
+
+	/** When the render target was returned to the pool, in platform seconds */
+	double ReleaseTime = 0.0;
+};
+
+/**
+ * Keeps the render targets of mesh widgets that went away, so widgets that come later can reuse them instead
+ * of creating new RHI resources.  Render targets are matched by size, format, gamma and clear color.
+ *
+ * Trim() destroys render targets that waited longer than r.MeshWidget.RenderTargetPool.MaxIdleTime and,
+ * oldest first, those above r.MeshWidget.RenderTargetPool.MaxFreeMB.
+ */
+UCLASS(Transient)
+class MESHWIDGET_API UMeshWidgetRenderTargetPool : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** @return A render target matching the description, reused from the pool if possible */
+	UTextureRenderTarget2D* Acquire(const FMeshWidgetRenderTargetDesc& Desc);
+
+	/** Returns a render target obtained from Acquire to the pool. */
+	void Release(UTextureRenderTarget2D* RenderTarget);
+
+	/**
+	 * Takes back a render target that was released but is still waiting in the pool.
+	 * @return False if the render target is not in the pool anymore
+	 */
+	bool Reclaim(UTextureRenderTarget2D* RenderTarget);
+
+	/** Destroys pooled render targets according to the trim policy. */
+	void Trim();
+
+	/** Destroys pooled render targets, oldest first, until the pool holds at most the given number of bytes. */
+	void TrimToSize(int64 MaxFreeBytes);
+
+	/** @return The memory used by the render targets handed out, in bytes */
+	int64 GetInUseMemorySize() const;
+
+	/** @return The memory used by the render targets waiting in the pool, in bytes */
+	int64 GetFreeMemorySize() const;
+
+	/** Destroys every pooled render target. */
+	void Empty();
+
+	/** @return The current counters of the pool */
+	FMeshWidgetRenderTargetPoolStats GetStats() const;
+
+private:
+	/** Drops a pooled render target and its RHI resource. */
+	void DestroyFreeRenderTarget(int32 FreeIndex);
+
+	/** Render targets that are handed out */
+	UPROPERTY(Transient)
+	TSet<UTextureRenderTarget2D*> InUseRenderTargets;
+
+	/** Render targets waiting to be reused, oldest first */
+	UPROPERTY(Transient)
+	TArray<FMeshWidgetPooledRenderTarget> FreeRenderTargets;
+
+	int32 NumHits;
+
+	int32 NumMisses;
+
+	int32 NumTrimmed;
+};
@@ -0,0 +1,305 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ConvexVolume.h"
+#include "MeshWidgetAtlasAllocator.h"
+#include "MeshWidgetRenderTargetPool.h"
+
+#include "MeshWidgetSubsystem.generated.h"
+
+class UMeshWidgetComponent;
+class UInstancedMeshWidgetComponent;
+class UTextureRenderTarget2D;
+
+/** A player view that mesh widgets are seen through this frame. */
+struct FMeshWidgetView
+{
+	/** Location of the view in the world */
+	FVector Origin;
+
+	/** The direction the view is looking in */
+	FVector Direction;
+
+	/** Projection matrix of the view */
+	FMatrix ProjectionMatrix;
+
+	/** Pixel rectangle of the view in the viewport */
+	FIntRect ViewRect;
+
+	/** The frustum of the view */
+	FConvexVolume Frustum;
+
+	/** A wider frustum catching what is about to come into view */
+	FConvexVolume PreDrawFrustum;
+};
+
+/** Where a primitive is relative to the player views. */
+enum class EMeshWidgetViewVisibility : uint8
+{
+	/** There are no views to test against */
+	Unknown,
+	/** Outside of every view */
+	Hidden,
+	/** Outside of every view, but close enough to an edge to come into view soon */
+	NearView,
+	/** Inside at least one view frustum */
+	InView,
+};
+
+/** Which render targets are released first when mesh widgets go over r.MeshWidget.RenderTargetBudgetMB. */
+UENUM(BlueprintType)
+enum class EMeshWidgetEvictionPolicy : uint8
+{
+	/** The widgets that have gone longest without being rendered on screen */
+	LeastRecentlySeen,
+	/** The widgets that matter least to the players, see UMeshWidgetSubsystem::GetSignificance */
+	LeastSignificant,
+};
+
+/** Render target memory of the mesh widgets in a world, against the budget set by r.MeshWidget.RenderTargetBudgetMB. */
+USTRUCT(BlueprintType)
+struct MESHWIDGET_API FMeshWidgetRenderTargetBudgetStats
+{
+	GENERATED_BODY()
+
+	/** The budget in megabytes, 0 if there is none */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	float BudgetMB = 0.0f;
+
+	/** Memory used by the render targets in use, the pooled ones and the atlas pages, in megabytes */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	float UsedMB = 0.0f;
+
+	/** The order in which render targets are released */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	EMeshWidgetEvictionPolicy Policy = EMeshWidgetEvictionPolicy::LeastRecentlySeen;
+
+	/** Widgets whose render target is released right now */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	int32 NumEvicted = 0;
+
+	/** Render targets released to stay within the budget */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	int32 NumEvictions = 0;
+
+	/** Released render targets acquired again because their widget came back into view */
+	UPROPERTY(BlueprintReadOnly, Category=UserInterface)
+	int32 NumReacquisitions = 0;
+};
+
+/** A render target shared by several mesh widgets, each one drawing into its own region. */
+USTRUCT()
+struct FMeshWidgetAtlasPage
+{
+	GENERATED_BODY()
+
+	/** The shared render target */
+	UPROPERTY(Transient)
+	UTextureRenderTarget2D* RenderTarget = nullptr;
+
+	/** Tracks which regions of the render target are in use */
+	FMeshWidgetAtlasAllocator Allocator;
+};
+
+/**
+ * Schedules the redraws of every mesh widget in a world.
+ *
+ * Mesh widget components register here when they are registered and, instead of drawing from their own tick,
+ * ask for a redraw slot whenever ShouldDrawWidget() passes.  Once per frame the pending requests are sorted by
+ * priority (screen coverage, hover state and time since the last draw) and drawn until the frame budget set by
+ * r.MeshWidget.FrameBudgetMs is spent.  Requests that don't fit roll over to the next frame, where they have
+ * waited longer and so rank higher.  Unless r.MeshWidget.DeferRenderTargetUpdates is 0, the scheduled draws hand
+ * their render target updates to the Slate renderer, which submits them together in a single render thread pass.
+ * r.MeshWidget.MaxRedrawsPerFrame caps the number of draws per frame, and r.MeshWidget.MaxLiveWidgets the number
+ * of widgets that aren't frozen.  The instances of instanced mesh widget components ask for slots too, one per
+ * instance due for a redraw, and share the same budget.
+ *
+ * When r.MeshWidget.RenderTargetBudgetMB is set, the render target memory of all mesh widgets is kept under it by
+ * emptying the pool and then releasing the render targets of widgets nobody sees, in the order picked by
+ * r.MeshWidget.RenderTargetEvictionPolicy.  Those widgets draw into a new render target once they come near a
+ * view again.
+ *
+ * The meshwidget.dump console command, also part of memreport through the plugin's config, lists the mesh widgets
+ * of the world by memory cost.
+ *
+ * It also owns the atlas pages that mesh widgets using bUseSharedAtlas are packed into, and the pool that the
+ * other mesh widgets and the instanced components take their render targets from and return them to.
+ */
+UCLASS()
+class MESHWIDGET_API UMeshWidgetSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// Begin USubsystem
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End USubsystem
+
+	// Begin FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableInEditor() const override { return true; }
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End FTickableGameObject
+
+	/** Adds a component to the set of mesh widgets managed by this world. */
+	void RegisterComponent(UMeshWidgetComponent* Component);
+
+	/** Removes a component and any redraw it still has pending. */
+	void UnregisterComponent(UMeshWidgetComponent* Component);
+
+	/** Asks for the component to be drawn this frame, or as soon as the frame budget allows. */
+	void RequestRedrawSlot(UMeshWidgetComponent* Component);
+
+	/** Adds an instanced component, whose instances are scheduled along with the mesh widgets. */
+	void RegisterComponent(UInstancedMeshWidgetComponent* Component);
+
+	/** Removes an instanced component and the redraws its instances still have pending. */
+	void UnregisterComponent(UInstancedMeshWidgetComponent* Component);
+
+	/**
+	 * Asks for an instance of the component to be drawn this frame, if the frame budget allows.  Instances that
+	 * don't fit aren't kept, they ask again on their next tick.
+	 */
+	void RequestRedrawSlot(UInstancedMeshWidgetComponent* Component, int32 InstanceIndex);
+
+	/** @return The largest screen size of the component's bounds across the current views, 0 if there are no views. */
+	float GetScreenCoverage(const UPrimitiveComponent* Component) const;
+
+	/** @return The largest screen size of the bounds across the current views, 0 if there are no views. */
+	float GetScreenCoverage(const FBoxSphereBounds& Bounds) const;
+
+	/** @return The largest projected diameter of the component's bounds across the current views in pixels, 0 if there are no views. */
+	float GetProjectedSize(const UPrimitiveComponent* Component) const;
+
+	/**
+	 * Rates how much the component matters to the players right now, from how far it is from the center of the
+	 * view, its size on screen, its distance, and whether it is hovered or animating.  A widget looked at head on
+	 * is fully significant unless it is tiny on screen, one outside the focus gets at most a quarter from its size
+	 * and distance.
+	 * @return 0 for a widget nobody pays attention to, 1 for one a player looks at; 1 if there are no views.
+	 */
+	float GetSignificance(const UMeshWidgetComponent* Component) const;
+
+	/** @return Where the component's bounds are relative to the frustums of the current views. */
+	EMeshWidgetViewVisibility GetViewVisibility(const UPrimitiveComponent* Component) const;
+
+	/** @return Where the bounds are relative to the frustums of the current views. */
+	EMeshWidgetViewVisibility GetViewVisibility(const FBoxSphereBounds& Bounds) const;
+
+	/** @return The player views gathered for this frame. */
+	const TArray<FMeshWidgetView>& GetViews() const { return Views; }
+
+	/**
+	 * Finds room for a widget in one of the shared atlas pages, growing a page or adding a new one if needed.
+	 * @param RegionSize The size of the widget's render target in texels
+	 * @param OutRegion (Out) The region of the page reserved for the widget
+	 * @return The render target of the page, or nullptr if the region is too big for an atlas page
+	 */
+	UTextureRenderTarget2D* AllocateAtlasRegion(FIntPoint RegionSize, FIntRect& OutRegion);
+
+	/** Returns a region obtained from AllocateAtlasRegion. */
+	void ReleaseAtlasRegion(UTextureRenderTarget2D* RenderTarget, const FIntRect& Region);
+
+	/** @return The pool that mesh widgets drawing to their own render target share. */
+	UMeshWidgetRenderTargetPool* GetRenderTargetPool() const { return RenderTargetPool; }
+
+	/** @return The counters of the render target pool. */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	FMeshWidgetRenderTargetPoolStats GetRenderTargetPoolStats() const;
+
+	/** @return The render target memory in use against the budget and how many render targets were released for it. */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	FMeshWidgetRenderTargetBudgetStats GetRenderTargetBudgetStats() const;
+
+	/**
+	 * Writes every registered mesh widget with its owner, class, draw size, memory and redraws to the output, most
+	 * expensive first, then every instanced component with its atlas and instance count.
+	 */
+	void DumpWidgets(FOutputDevice& Ar) const;
+
+	/** @return Number of shared atlas render targets. */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	int32 GetNumAtlasPages() const { return AtlasPages.Num(); }
+
+	/** @return Number of redraws that are waiting for a slot. */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	int32 GetNumPendingRedraws() const { return PendingRedraws.Num() + PendingInstanceRedraws.Num(); }
+
+	/** @return Number of widgets drawn during the last frame. */
+	UFUNCTION(BlueprintCallable, Category=UserInterface)
+	int32 GetNumRedrawsLastFrame() const { return NumRedrawsLastFrame; }
+
+protected:
+	/** Gathers the views before any component ticks, so visibility, LOD and significance use this frame's views. */
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick InLevelTick, float InDeltaSeconds);
+
+	/** Collects the views of the local players for this frame. */
+	void GatherViews();
+
+	/**
+	 * Freezes the least significant widgets beyond r.MeshWidget.MaxLiveWidgets and thaws them once there is room,
+	 * a few per frame.  Their last draw before freezing waits for a redraw slot like any other.
+	 */
+	void UpdateLiveWidgetLimit();
+
+	/** Gives render targets back to widgets that are seen again, then releases render targets until the budget is met. */
+	void UpdateRenderTargetBudget();
+
+	/** @return The memory used by the render targets of the pool, which include the atlases of the instanced components, and the atlas pages, in bytes. */
+	int64 GetRenderTargetMemorySize() const;
+
+	/** @return How urgently the component wants to be redrawn, higher is drawn first. */
+	float GetRedrawPriority(const UMeshWidgetComponent* Component) const;
+
+	/** @return How urgently the instance wants to be redrawn, on the same scale as the mesh widgets. */
+	float GetRedrawPriority(const UInstancedMeshWidgetComponent* Component, int32 InstanceIndex) const;
+
+	/** Grows an atlas page.  Widgets in the page get their new UVs and are redrawn, resizing loses the contents. */
+	void ResizeAtlasPage(FMeshWidgetAtlasPage& Page, FIntPoint NewSize);
+
+protected:
+	/** All mesh widget components registered in this world */
+	UPROPERTY(Transient)
+	TArray<UMeshWidgetComponent*> Components;
+
+	/** Components waiting for a redraw slot, a set so requests and draws don't search the others */
+	UPROPERTY(Transient)
+	TSet<UMeshWidgetComponent*> PendingRedraws;
+
+	/** All instanced mesh widget components registered in this world */
+	UPROPERTY(Transient)
+	TArray<UInstancedMeshWidgetComponent*> InstancedComponents;
+
+	/** Instances asking for a redraw slot this frame, their components are kept alive by InstancedComponents */
+	TSet<TPair<UInstancedMeshWidgetComponent*, int32>> PendingInstanceRedraws;
+
+	/** Render targets shared by the widgets drawing into an atlas */
+	UPROPERTY(Transient)
+	TArray<FMeshWidgetAtlasPage> AtlasPages;
+
+	/** Render targets of widgets that don't use the atlas */
+	UPROPERTY(Transient)
+	UMeshWidgetRenderTargetPool* RenderTargetPool;
+
+	/** The local player views of the current frame */
+	TArray<FMeshWidgetView> Views;
+
+	/** Handle of OnWorldPreActorTick on FWorldDelegates::OnWorldPreActorTick */
+	FDelegateHandle WorldPreActorTickHandle;
+
+	/** How many widgets were drawn in the last frame */
+	int32 NumRedrawsLastFrame;
+
+	/** Render targets released to stay within the budget */
+	int32 NumRenderTargetEvictions;
+
+	/** Released render targets acquired again */
+	int32 NumRenderTargetReacquisitions;
+};